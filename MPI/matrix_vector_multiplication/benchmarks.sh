@@ -8,6 +8,7 @@ IFS=$'\n\t' #This defines how Bash splits words when expanding variables, readin
 readonly EXECUTABLE="executable"
 readonly MPI_SOURCE="mtx_vct_mult.c"
 readonly HELPERS_SRC="helpers/helpers.c"
+readonly ALLOC_SRC="../../helpers/mtx_alloc.c"
 
 # Number of runs per process count for averaging
 readonly RUNS_PER_NPROCS=3
@@ -25,7 +26,7 @@ function compile_program {
     echo "======================================================"
 
 # Compile the MPI program using mpicc
-    mpicc -o "$EXECUTABLE" "$MPI_SOURCE" "$HELPERS_SRC" -lm
+    mpicc -o "$EXECUTABLE" "$MPI_SOURCE" "$HELPERS_SRC" "$ALLOC_SRC" -lm
 
     if [ $? -ne 0 ]; then
         echo "ERROR: Compilation Failed for ${MPI_SOURCE}"
@@ -3,6 +3,7 @@
 #include <math.h>
 
 #include "helpers.h"
+#include "../../../helpers/mtx_alloc.h"
 
 /* -------------------- Usage / Help -------------------- */
 void usage(char *prog_name) {
@@ -45,13 +46,13 @@ void mtx_vct_mul(double A[], double x[], double y[], int n){
 int malloc2double(double ***array, int n) {
     
     /* allocate the n*m contiguous items */
-    double *p = (double *)malloc(n*n*sizeof(double));
+    double *p = (double *)mtx_alloc((size_t)n*n*sizeof(double));
     if (!p) return -1;
 
     /* allocate the row pointers into the memory */
     (*array) = (double **)malloc(n*sizeof(double*));
     if (!(*array)) {
-       free(p);
+       mtx_free(p);
        return -1;
     }
 
@@ -65,7 +66,7 @@ int malloc2double(double ***array, int n) {
 /* -------------- Matrix Memory De-Allocation -------------- */
 int free2double(double ***array) {
     /* free the memory - the first element of the array is at the start */
-    free(&((*array)[0][0]));
+    mtx_free(&((*array)[0][0]));
 
     /* free the pointers into the memory */
     free(*array);
@@ -9,7 +9,7 @@
  *     Result Validation: Correct ot Wrong Vector Product
  * Compile:  
  *     1. Terminal Command for Local run:
- *              mpicc -o executable mtx_vct_mult.c helpers/helpers.c -lm 
+ *              mpicc -o executable mtx_vct_mult.c helpers/helpers.c ../../helpers/mtx_alloc.c -lm 
  *     2. Makefile:
  *              make
  * Usage:
@@ -30,6 +30,7 @@
 
 #include "helpers/helpers.h"
 #include "../../helpers/timer.h"
+#include "../../helpers/mtx_alloc.h"
 
 double start, finish;
 /* ---------------------------- Main Function ---------------------------- */
@@ -74,8 +75,8 @@ int main(int argc, char **argv) {
     
 // --- 2. Allocate and Initialize Global Data ---
         malloc2double(&global, global_mtx_dimension);
-        global_vector_v = (double*)malloc(global_mtx_dimension*sizeof(double));
-        global_vector_p = (double*)malloc(global_mtx_dimension*sizeof(double));
+        global_vector_v = (double*)mtx_alloc(global_mtx_dimension*sizeof(double));
+        global_vector_p = (double*)mtx_alloc(global_mtx_dimension*sizeof(double));
         gen_mtx_vct(global , global_vector_v , global_mtx_dimension);    
         
         //In case of only one process provided
@@ -96,8 +97,8 @@ int main(int argc, char **argv) {
     MPI_Bcast(&local_dim , 1 , MPI_INT , 0 , comm);
 
     malloc2double(&local, local_dim);
-    local_v = malloc((local_dim)*sizeof(double));
-    local_p = malloc((local_dim)*sizeof(double));
+    local_v = mtx_alloc((local_dim)*sizeof(double));
+    local_p = mtx_alloc((local_dim)*sizeof(double));
 
 // ---4. Global Matrix Distribution ---
     // Create derived datatype
@@ -186,13 +187,13 @@ int main(int argc, char **argv) {
         // free(serial_p);
 
         free2double(&global);
-        free(global_vector_v);
-        free(global_vector_p);
+        mtx_free(global_vector_v);
+        mtx_free(global_vector_p);
     }
 
 // --- 10. Free Allocated Memory ---
-    free(local_v);
-    free(local_p);
+    mtx_free(local_v);
+    mtx_free(local_p);
 
     free2double(&local);
 
@@ -3,7 +3,7 @@
  *     method.
  *
  * Compile:
- *    1. gcc -g -Wall -o executable gauss_elim.c gauss_main.c helpers/helpers.c ../../helpers/my_rand.c -fopenmp
+ *    1. gcc -g -Wall -o executable gauss_elim.c gauss_main.c helpers/helpers.c ../../helpers/my_rand.c ../../helpers/mtx_alloc.c -fopenmp
  *    2. make
  * Run:
  *    1. ./executable <num_of_equations> <thread_num> 
@@ -25,6 +25,7 @@
 #include <omp.h>
 #include "../../helpers/my_rand.h"
 #include "../../helpers/timer.h"
+#include "../../helpers/mtx_alloc.h"
 
 #include "helpers/helpers.h"
 
@@ -43,15 +44,25 @@ int main(int argc, char *argv[]){
 
 // --- 2. Linear System Initialization --- 
 // B is for validation
+// One aligned block per matrix, rows padded to whole cache lines
+    long row_len = (n + MTX_ALIGN / sizeof(double) - 1) / (MTX_ALIGN / sizeof(double)) 
+                   * (MTX_ALIGN / sizeof(double));
+    double *A_data = mtx_alloc((size_t)n * row_len * sizeof(double));
+    double *B_data = mtx_alloc((size_t)n * row_len * sizeof(double));
     double **A = (double **)malloc(n * sizeof(double *));
     double **B = (double **)malloc(n * sizeof(double *));
 
-    for (int i = 0; i < n; i++){
-        A[i] = (double *)malloc(n * sizeof(double));
-        B[i] = (double *)malloc(n * sizeof(double));
-    }
-
+// Rows are filled in static blocks by all the threads, so their pages 
+// are spread over the threads' NUMA nodes instead of the first thread's.
+// (The elimination loop shrinks every step, so no thread keeps its rows.)
+// Every row has its own random stream, so the system is the same for 
+// any number of threads.
+#pragma omp parallel for private(j, seed) shared(A, B, A_data, B_data, row_len, b_parallel, b_serial, n) \
+    num_threads(num_of_threads) schedule(static)
     for (i = 0; i < n; i++){
+        A[i] = &A_data[i * row_len];
+        B[i] = &B_data[i * row_len];
+        seed = my_seed(i);
         for (j = 0; j < n; j++){
             A[i][j] = my_drand(&seed);
             B[i][j] = A[i][j];
@@ -66,10 +77,9 @@ int main(int argc, char *argv[]){
     // serial_gauss(A, B, n, b0, x_serial, x, b);
 
 // --- 4. Free Memory --- 
-    for (int i = 0; i < n; i++){
-        free(A[i]);
-        free(B[i]);
-    }
+    mtx_alloc_report();
+    mtx_free(A_data);
+    mtx_free(B_data);
     free(A);
     free(B);
     return EXIT_SUCCESS;
@@ -11,6 +11,7 @@ readonly SOURCE_CODE="gauss_main.c"
 readonly GAUSS_SRC="gauss_elim.c"
 readonly HELPERS_GAUSS_SRC="helpers/helpers.c"
 readonly HELPERS_SRC="../../helpers/my_rand.c"
+readonly ALLOC_SRC="../../helpers/mtx_alloc.c"
 readonly CFLAGS="-fopenmp"
 readonly EXECUTABLE="executable"
 
@@ -33,7 +34,7 @@ function compile_program {
     echo " --> Compiling: $SOURCE_CODE"
     echo "======================================================"
 
-    gcc -o "$EXECUTABLE" "$SOURCE_CODE" "$GAUSS_SRC" "$HELPERS_GAUSS_SRC" "$HELPERS_SRC" "$CFLAGS"
+    gcc -o "$EXECUTABLE" "$SOURCE_CODE" "$GAUSS_SRC" "$HELPERS_GAUSS_SRC" "$HELPERS_SRC" "$ALLOC_SRC" "$CFLAGS"
 
     if [ $? -ne 0 ]; then
         echo "Compilation FAILED. Aborting." >&2
@@ -4,9 +4,15 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
+#include <omp.h>
 
+#include "../../../helpers/my_rand.h"
+#include "../../../helpers/tuning.h"
 #include "helpers.h"
 
+#define TUNE_REPS 3
+
 /*------------------------------------------------------------------
  * Function:  Get_args
  * Purpose:   Get command line args
@@ -20,7 +26,7 @@ void get_args(int argc, char *argv[], int *thread_count_p,
     *thread_count_p = strtol(argv[1], NULL, 10);
     *m_p = strtol(argv[2], NULL, 10);
     *n_p = strtol(argv[3], NULL, 10);
-    if (*thread_count_p <= 0 || *m_p <= 0 || *n_p <= 0)
+    if (*thread_count_p < 0 || *m_p <= 0 || *n_p <= 0)
         usage(argv[0]);
 } 
 
@@ -32,6 +38,7 @@ void get_args(int argc, char *argv[], int *thread_count_p,
  */
 void usage(char *prog_name){
     fprintf(stderr, "usage: %s <thread_count> <m> <n>\n", prog_name);
+    fprintf(stderr, "       thread_count 0 picks threads and schedule from the tuning cache\n");
     exit(0);
 }
 
@@ -52,33 +59,41 @@ void read_matrix(char *prompt, double A[], int m, int n){
 
 /*------------------------------------------------------------------
  * Function: Gen_matrix
- * Purpose:  Use the random number generator random to generate
- *    the entries in A
- * In args:  m, n
+ * Purpose:  Generate the entries in A in parallel. The rows are split
+ *    with the same schedule(static) as the product loop, so every
+ *    page is first touched (and placed on a NUMA node) by the thread
+ *    that later computes on it. Each row has its own seed, so A does
+ *    not depend on the number of threads.
+ * In args:  m, n, thread_count
  * Out arg:  A
  */
-void gen_matrix(double A[], int m, int n){
+void gen_matrix(double A[], int m, int n, int thread_count){
     int i, j;
-    for (i = 0; i < m; i++)
+#pragma omp parallel for num_threads(thread_count) \
+    default(none) private(i, j) shared(A, m, n) schedule(static)
+    for (i = 0; i < m; i++){
+        unsigned seed = my_seed(i);
         for (j = 0; j < n; j++){
             if (i > j) // condition for the matrix to be
                 A[i * n + j] = 0;
             else
-                A[i * n + j] = random() / ((double)RAND_MAX);
+                A[i * n + j] = my_rand(&seed) / ((double)UINT_MAX);
         }
+    }
 }
 
 /*------------------------------------------------------------------
  * Function: Gen_vector
- * Purpose:  Use the random number generator random to generate
+ * Purpose:  Use the random number generator my_rand to generate
  *    the entries in x
  * In arg:   n
  * Out arg:  A
  */
 void gen_vector(double x[], int n){
     int i;
+    unsigned seed = my_seed(n);
     for (i = 0; i < n; i++)
-        x[i] = random() / ((double)RAND_MAX);
+        x[i] = my_rand(&seed) / ((double)UINT_MAX);
 }
 
 /*------------------------------------------------------------------
@@ -125,3 +140,81 @@ void print_vector(char *title, double y[], double m){
         printf("%4.1f ", y[i]);
     printf("\n");
 } 
+
+/*------------------------------------------------------------------
+ * Function:    Tuned_threads
+ * Purpose:     Choose the schedule of the product loop (it uses
+ *              schedule(runtime)). A positive thread_count keeps the
+ *              plain schedule(static). 0 looks up the tuning cache.
+ * In args:     program, m, n, thread_count
+ * Return val:  The number of threads, 0 if the cache has no entry
+ *              and autotune_mat_vect has to search
+ */
+int tuned_threads(const char *program, int m, int n, int thread_count){
+    char size_class[TUNE_CLASS_LEN];
+    long dims[2] = {m, n};
+    tune_config cfg = {0};
+
+    if (thread_count > 0){
+        omp_set_schedule(omp_sched_static, 0);
+        return thread_count;
+    }
+    tune_class(size_class, dims, 2);
+    if (!tune_load(program, size_class, &cfg))
+        return 0;
+
+    omp_set_schedule((omp_sched_t)tune_get(&cfg, "schedule", omp_sched_static),
+                     tune_get(&cfg, "chunk", 0));
+    tune_print("Tuning cache", &cfg);
+    return tune_get(&cfg, "threads", 1);
+}
+
+/*------------------------------------------------------------------
+ * Function:    Autotune_mat_vect
+ * Purpose:     Time the product for every thread count (powers of
+ *              two up to the number of cpus), schedule kind and
+ *              chunk size, keep the fastest (best of TUNE_REPS runs)
+ *              and store it in the tuning cache.
+ * In args:     program, kernel, A, x, m, n
+ * Out arg:     y
+ * Return val:  The number of threads of the winner, whose schedule
+ *              is left set
+ */
+int autotune_mat_vect(const char *program, mat_vect_fn kernel, const double A[],
+                      const double x[], double y[], int m, int n){
+    const omp_sched_t kinds[] = {omp_sched_static, omp_sched_dynamic, omp_sched_guided};
+    const int chunks[] = {0, 1, 16, 256};
+    int max_threads = tune_max_threads();
+    char size_class[TUNE_CLASS_LEN];
+    long dims[2] = {m, n};
+    tune_config best = {0};
+    double best_time = -1.0;
+
+    for (int threads = 1; threads <= max_threads;
+         threads = (threads * 2 > max_threads && threads < max_threads) ? max_threads : threads * 2)
+        for (int k = 0; k < 3; k++)
+            for (int c = 0; c < 4; c++){
+                double elapsed = -1.0;
+
+                omp_set_schedule(kinds[k], chunks[c]);
+                for (int rep = 0; rep < TUNE_REPS; rep++){
+                    double t = kernel(A, x, y, m, n, threads);
+                    if (elapsed < 0 || t < elapsed)
+                        elapsed = t;
+                }
+                if (best_time < 0 || elapsed < best_time){
+                    best_time = elapsed;
+                    tune_set(&best, "threads", threads);
+                    tune_set(&best, "schedule", kinds[k]);
+                    tune_set(&best, "chunk", chunks[c]);
+                }
+            }
+
+    tune_class(size_class, dims, 2);
+    tune_store(program, size_class, &best, best_time);
+    tune_print("Autotuned", &best);
+
+    omp_set_schedule((omp_sched_t)tune_get(&best, "schedule", omp_sched_static),
+                     tune_get(&best, "chunk", 0));
+    return tune_get(&best, "threads", 1);
+}
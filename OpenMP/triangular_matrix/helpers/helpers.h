@@ -5,16 +5,23 @@
 #ifndef _HELPERS_H
 #define _HELPERS_H
 
+/* Signature of the matrix-vector products, it returns the elapsed time */
+typedef double (*mat_vect_fn)(const double A[], const double x[], double y[],
+                              int m, int n, int thread_count);
+
 /* ----------------- Function Prototypes ----------------- */
 void get_args(int argc, char *argv[], int *thread_count_p,
               int *m_p, int *n_p);
 void usage(char *prog_name);
-void gen_matrix(double A[], int m, int n);
+void gen_matrix(double A[], int m, int n, int thread_count);
 void read_matrix(char *prompt, double A[], int m, int n);
 void gen_vector(double x[], int n);
 void read_vector(char *prompt, double x[], int n);
 void print_matrix(char *title, double A[], int m, int n);
 void print_vector(char *title, double y[], double m);
+int tuned_threads(const char *program, int m, int n, int thread_count);
+int autotune_mat_vect(const char *program, mat_vect_fn kernel, const double A[],
+                      const double x[], double y[], int m, int n);
 
 
 #endif
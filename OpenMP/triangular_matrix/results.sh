@@ -11,6 +11,9 @@ IFS=$'\n\t' #This defines how Bash splits words when expanding variables, readin
 readonly PROGRAMS=("unecessary_calculations.c" "only_necessary.c") 
 readonly EXECUTABLE="./mm_bench" # Single, consistent executable name
 readonly HELPERS_SRC="helpers/helpers.c"
+readonly RAND_SRC="../../helpers/my_rand.c"
+readonly TUNING_SRC="../../helpers/tuning.c"
+readonly ALLOC_SRC="../../helpers/mtx_alloc.c"
 readonly THREADS_START=2
 readonly THREADS=(2 4 8) #Runs for 2, 4, 8 threads (3 iterations)
 readonly RUNS_PER_THREAD=3
@@ -31,7 +34,7 @@ run_benchmark() {
     
     # Compile the source file, checking for errors
     # Using global constants EXECUTABLE and HELPERS_SRC
-    gcc -o "$EXECUTABLE" "$source" "$HELPERS_SRC" -fopenmp
+    gcc -o "$EXECUTABLE" "$source" "$HELPERS_SRC" "$RAND_SRC" "$TUNING_SRC" "$ALLOC_SRC" -fopenmp -lm
     if [ $? -ne 0 ]; then
         echo "--> Compilation of $source FAILED. Skipping." >&2
         return 1
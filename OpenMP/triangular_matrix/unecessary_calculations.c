@@ -4,7 +4,7 @@
  *     blocks.  This version uses a random number generator to
  *     generate A and x. 
  * Compile:
- *    1. gcc -g -Wall -o executable only_necessary.c helpers/helpers.c -fopenmp 
+ *    1. gcc -g -Wall -o executable only_necessary.c helpers/helpers.c ../../helpers/my_rand.c ../../helpers/tuning.c ../../helpers/mtx_alloc.c -fopenmp -lm 
  *    2. make build SRC=filename.c
  * Run:
  *    1. ./executable <thread_count> <m> <n>
@@ -24,6 +24,9 @@
  *    Elapsed time for the computation
  *
  * Notes:
+ *     thread_count 0 runs with the fastest threads/schedule/chunk
+ *     stored in tuning.cache for this machine and size class, and
+ *     searches for it (storing the winner) when there is none.
  *     Number of threads (thread_count) should evenly divide
  *     both m and n. The program doesn't check for this.
  *     This program calculates the product for all the elements 
@@ -36,30 +39,33 @@
 #include <omp.h>
 
 #include "../../helpers/timer.h"
+#include "../../helpers/mtx_alloc.h"
 #include "helpers/helpers.h"
 
 /* -------------------- Function Prototypes -------------------- */
-void omp_mat_vect(const double A[], const double x[], double y[],
-                  int m, int n, int thread_count);
+double omp_mat_vect(const double A[], const double x[], double y[],
+                    int m, int n, int thread_count);
 
 /* ---------------------- Main Function ----------------------- */
 int main(int argc, char *argv[]){
 // --- 1. Argument Validation and Parsing ---
     int thread_count, m, n;
     get_args(argc, argv, &thread_count, &m, &n);
+// thread_count 0: configuration from the tuning cache (or a new search)
+    thread_count = tuned_threads("unecessary_calculations", m, n, thread_count);
 
 // --- 2. Allocate Matrices ---
     double *A = NULL;
     double *x = NULL;
     double *y = NULL;
 
-    A = malloc((size_t)m * n * sizeof(double));
-    x = malloc((size_t)n * sizeof(double));
-    y = malloc((size_t)m * sizeof(double));
+    A = mtx_alloc((size_t)m * n * sizeof(double));
+    x = mtx_alloc((size_t)n * sizeof(double));
+    y = mtx_alloc((size_t)m * sizeof(double));
 
     if (!A || !x || !y) {
         fprintf(stderr, "Memory allocation failed.\n");
-        free(A); free(x); free(y);
+        mtx_free(A); mtx_free(x); mtx_free(y);
         return EXIT_FAILURE;
     }
 
@@ -69,32 +75,36 @@ int main(int argc, char *argv[]){
     read_vector("Enter the vector", x, n);
     print_vector("We read", x, n);
 #else
-    gen_matrix(A, m, n);
+    gen_matrix(A, m, n, thread_count ? thread_count : omp_get_max_threads());
     gen_vector(x, n);
 #endif
 // --- 3. Invoke OpenMP function ---
-    omp_mat_vect(A, x, y, m, n, thread_count);
+    if (thread_count == 0)
+        thread_count = autotune_mat_vect("unecessary_calculations", omp_mat_vect, A, x, y, m, n);
+    double elapsed = omp_mat_vect(A, x, y, m, n, thread_count);
+    printf("Elapsed Time: %.6e seconds\n", elapsed);
 
 #ifdef DEBUG
 pPrint_vector("The product is", y, m);
 #endif
+    mtx_alloc_report();
 // --- 5. Free Memory  --- 
-    free(A);
-    free(x);
-    free(y);
+    mtx_free(A);
+    mtx_free(x);
+    mtx_free(y);
 
     return EXIT_SUCCESS;
 }
 
 /* ------------ Parallel Matrix x Vector Multiplication ------------ */
-void omp_mat_vect(const double A[], const double x[], double y[],
-                  int m, int n, int thread_count){
+double omp_mat_vect(const double A[], const double x[], double y[],
+                    int m, int n, int thread_count){
     double start, finish;
 
     GET_TIME(start);
     int i,j;
 #pragma omp parallel for num_threads(thread_count) \
-    default(none) private(i,j) shared(A,x,y,m,n) schedule(static)
+    default(none) private(i,j) shared(A,x,y,m,n) schedule(runtime)
     for (i = 0; i < m; i++) {
         double sum = 0.0;              // thread-local
         for (j = 0; j < n; j++) // FIXED: correct full row
@@ -105,5 +115,5 @@ void omp_mat_vect(const double A[], const double x[], double y[],
 
     GET_TIME(finish);
 
-    printf("Elapsed Time: %.6e seconds\n", finish - start);
+    return finish - start;
 }
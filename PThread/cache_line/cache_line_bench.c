@@ -0,0 +1,298 @@
+/* Purpose:
+ *     Measures what false sharing costs on this machine. Two threads
+ *     increment their own counter; the counters are `stride` bytes
+ *     apart, so below the cache line size they share a line. The
+ *     program reads the line size and the cpu topology from sysfs and
+ *     sweeps:
+ *         stride:     8 bytes .. 4 cache lines
+ *         placement:  not pinned, two hyper-threads of one core (smt),
+ *                     two cores of one socket, two sockets (cross)
+ *         frequency:  one write every 1, 4, 16 or 64 iterations
+ * Output:
+ *     The cache geometry and topology
+ *     For every case the time per iteration and the slowdown against
+ *     private lines (stride of 4 lines)
+ *     A cost-per-shared-line table (extra ns per write) and the
+ *     smallest slot size that avoids false sharing, per placement
+ * Compile:
+ *     1. gcc -Wall -O2 -o executable cache_line_bench.c ../../helpers/topology.c -lpthread
+ *     2. make
+ * Usage:
+ *     1. ./executable <iterations> [csv_file]
+ *     2. make run n=<iterations> [csv=<csv_file>]
+ *     With csv_file every case is appended there as
+ *         host,line_size,placement,cpu_a,cpu_b,stride,write_every,ns_per_iter,extra_ns_per_write
+ *     so that the results of several machines can be collected in one file.
+ * Notes:
+ *     1.  Placements that the machine (or the cpuset of the process)
+ *         does not have are skipped. With a single cpu only "any" is
+ *         measured and the two threads share the core by time slicing.
+ *     2.  The threads are timed with their cpu clock
+ *         (CLOCK_THREAD_CPUTIME_ID), not the wall clock: the stalls on
+ *         a contended line are counted, the time a thread spends
+ *         descheduled is not.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <time.h>
+#include <pthread.h>
+#include "../../helpers/topology.h"
+
+#define NUM_THREADS 2
+#define REPS 3
+#define MAX_STRIDES 8
+#define NUM_FREQS 4
+// A slot is "free of false sharing" when it is within this of private lines
+#define SLOWDOWN_LIMIT 1.10
+
+/* Arguments and results of one writer thread */
+typedef struct{
+    volatile long *slot;
+    long iterations;
+    long write_every;      // power of two
+    int cpu;               // -1: not pinned
+    int pinned;            // out: 0 if the affinity could not be set
+    double elapsed;        // out
+    unsigned long work;    // out: keeps the loop from being optimized away
+    pthread_barrier_t *barrier;
+}writer_arg;
+
+/* ------------------ Global Variables ------------------ */
+const long freqs[NUM_FREQS] = {1, 4, 16, 64};
+int strides[MAX_STRIDES], stride_count;
+int line_size;
+char *buffer;
+
+/* ------------------ Function Prototypes ------------------ */
+void *writer(void *arg);
+double run_case(int cpu_a, int cpu_b, int stride, long write_every, long iterations);
+int allowed_cpus(topo_cpu cpus[]);
+void set_strides(void);
+
+/* ------------------ Writer Thread ------------------ */
+void *writer(void *arg){
+    writer_arg *my = arg;
+    volatile long *slot = my->slot;
+    unsigned long mask = my->write_every - 1;
+    unsigned long work = (unsigned long)slot;
+    struct timespec start, finish;
+
+    my->pinned = 1;
+    if (my->cpu >= 0){
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(my->cpu, &set);
+        my->pinned = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+
+    pthread_barrier_wait(my->barrier);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+    for (long i = 0; i < my->iterations; i++){
+// Some private work between the writes (an LCG step)
+        work = work * 6364136223846793005UL + 1442695040888963407UL;
+        if ((i & mask) == 0)
+            *slot += 1;
+    }
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &finish);
+
+    my->elapsed = (finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec) / 1e9;
+    my->work = work;
+    return NULL;
+}
+
+/* ------------------ One Case ------------------
+ * Returns the best (over REPS runs) time per iteration in ns of the
+ * slowest thread, or -1 if the threads could not be pinned.
+ */
+double run_case(int cpu_a, int cpu_b, int stride, long write_every, long iterations){
+    pthread_t handles[NUM_THREADS];
+    writer_arg args[NUM_THREADS];
+    pthread_barrier_t barrier;
+    int cpus[NUM_THREADS] = {cpu_a, cpu_b};
+    double best = -1.0;
+
+    pthread_barrier_init(&barrier, NULL, NUM_THREADS);
+    for (int rep = 0; rep < REPS; rep++){
+        double slowest = 0.0;
+
+        memset(buffer, 0, (size_t)4 * line_size * NUM_THREADS);
+        for (int t = 0; t < NUM_THREADS; t++){
+            args[t].slot = (volatile long *)(buffer + (size_t)t * stride);
+            args[t].iterations = iterations;
+            args[t].write_every = write_every;
+            args[t].cpu = cpus[t];
+            args[t].barrier = &barrier;
+            pthread_create(&handles[t], NULL, writer, &args[t]);
+        }
+        for (int t = 0; t < NUM_THREADS; t++)
+            pthread_join(handles[t], NULL);
+
+        for (int t = 0; t < NUM_THREADS; t++){
+            if (!args[t].pinned){
+                pthread_barrier_destroy(&barrier);
+                return -1.0;
+            }
+            if (args[t].elapsed > slowest)
+                slowest = args[t].elapsed;
+        }
+        if (best < 0 || slowest < best)
+            best = slowest;
+    }
+    pthread_barrier_destroy(&barrier);
+
+    return best * 1e9 / iterations;
+}
+
+/* ------------------ Cpus of this Process ------------------
+ * The online cpus that the affinity mask of the process allows.
+ */
+int allowed_cpus(topo_cpu cpus[]){
+    int ncpus = topo_cpus(cpus, TOPO_MAX_CPUS), count = 0;
+    cpu_set_t set;
+
+    if (sched_getaffinity(0, sizeof(set), &set) != 0)
+        return ncpus;
+    for (int i = 0; i < ncpus; i++)
+        if (cpus[i].cpu < CPU_SETSIZE && CPU_ISSET(cpus[i].cpu, &set))
+            cpus[count++] = cpus[i];
+    return count;
+}
+
+/* ------------------ Strides to Sweep ------------------
+ * 8, 16, 32 ... bytes up to 4 cache lines. The last one is the
+ * private baseline: not even adjacent lines are shared.
+ */
+void set_strides(void){
+    stride_count = 0;
+    for (int s = sizeof(long); s <= 4 * line_size && stride_count < MAX_STRIDES; s *= 2)
+        strides[stride_count++] = s;
+}
+
+/* ---------------------------- Main Function ---------------------------- */
+int main(int argc, char *argv[]){
+// --- 1. Argument Validation and Parsing ---
+    if (argc < 2 || argc > 3){
+        fprintf(stderr, "Usage: %s <iterations> [csv_file]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    long iterations = strtol(argv[1], NULL, 10);
+    if (iterations <= 0){
+        fprintf(stderr, "Iterations must be positive.\n");
+        return EXIT_FAILURE;
+    }
+    FILE *csv = NULL;
+    if (argc == 3 && (csv = fopen(argv[2], "a")) == NULL){
+        perror(argv[2]);
+        return EXIT_FAILURE;
+    }
+
+// --- 2. Cache Geometry and Topology ---
+    topo_cpu *cpus = malloc(TOPO_MAX_CPUS * sizeof(topo_cpu));
+    int ncpus = allowed_cpus(cpus);
+    char host[64] = "unknown";
+
+    gethostname(host, sizeof(host) - 1);
+    line_size = topo_line_size();
+    topo_print();
+    set_strides();
+
+// The counters start on a page boundary, so stride 8 shares one line
+    if (posix_memalign((void **)&buffer, 4096, (size_t)4 * line_size * NUM_THREADS) != 0){
+        perror("posix_memalign");
+        return EXIT_FAILURE;
+    }
+
+// --- 3. Sweep ---
+    double extra[TOPO_PLACEMENTS][NUM_FREQS];
+    int slot_size[TOPO_PLACEMENTS];
+    int measured[TOPO_PLACEMENTS] = {0}; // frequencies measured: the sweep stops at the first failure
+
+    printf("\n%-8s %-9s %7s %11s %12s %9s\n",
+           "place", "cpus", "stride", "write_every", "ns/iter", "slowdown");
+    for (int place = TOPO_ANY; place < TOPO_PLACEMENTS; place++){
+        int cpu_a, cpu_b;
+        char pair[16];
+
+        if (!topo_pick_pair(cpus, ncpus, place, &cpu_a, &cpu_b)){
+            printf("%-8s (no such pair of cpus, skipped)\n", topo_placement_name(place));
+            continue;
+        }
+        if (cpu_a < 0)
+            snprintf(pair, sizeof(pair), "-");
+        else
+            snprintf(pair, sizeof(pair), "%d,%d", cpu_a, cpu_b);
+        slot_size[place] = strides[stride_count - 1];
+
+        for (int f = 0; f < NUM_FREQS; f++){
+            double ns[MAX_STRIDES];
+            long writes = freqs[f];
+
+// The private baseline goes first, the slowdowns are relative to it
+            ns[stride_count - 1] = run_case(cpu_a, cpu_b, strides[stride_count - 1], writes, iterations);
+            if (ns[stride_count - 1] < 0)
+                break;
+            for (int s = 0; s < stride_count - 1; s++)
+                ns[s] = run_case(cpu_a, cpu_b, strides[s], writes, iterations);
+
+            for (int s = 0; s < stride_count; s++){
+                double slowdown = ns[s] / ns[stride_count - 1];
+// Extra time per write (each thread writes once every `writes` iterations)
+                double extra_ns = (ns[s] - ns[stride_count - 1]) * writes;
+
+                printf("%-8s %-9s %7d %11ld %12.3f %8.2fx%s\n",
+                       topo_placement_name(place), pair, strides[s], writes,
+                       ns[s], slowdown, strides[s] < line_size ? "  (shared line)" : "");
+                if (csv)
+                    fprintf(csv, "%s,%d,%s,%d,%d,%d,%ld,%.4f,%.4f\n", host, line_size,
+                            topo_placement_name(place), cpu_a, cpu_b, strides[s],
+                            writes, ns[s], extra_ns);
+            }
+            extra[place][f] = (ns[0] - ns[stride_count - 1]) * writes;
+
+// Smallest slot that is as fast as private lines when writing every iteration
+            if (f == 0)
+                for (int s = stride_count - 1; s >= 0 && ns[s] <= SLOWDOWN_LIMIT * ns[stride_count - 1]; s--)
+                    slot_size[place] = strides[s];
+            measured[place] = f + 1;
+        }
+        if (!measured[place])
+            printf("%-8s (could not pin the threads, skipped)\n", topo_placement_name(place));
+    }
+
+// --- 4. Cost per Shared Line ---
+    printf("\nCost per shared line (extra ns per write, stride %d bytes)\n", strides[0]);
+    printf("%-8s", "place");
+    for (int f = 0; f < NUM_FREQS; f++){
+        char title[16];
+        snprintf(title, sizeof(title), "1/%ld", freqs[f]);
+        printf(" %14s", title);
+    }
+    printf(" %10s\n", "slot size");
+    for (int place = TOPO_ANY; place < TOPO_PLACEMENTS; place++){
+        if (!measured[place])
+            continue;
+        printf("%-8s", topo_placement_name(place));
+        for (int f = 0; f < NUM_FREQS; f++){
+            if (f < measured[place])
+                printf(" %14.2f", extra[place][f]);
+            else
+                printf(" %14s", "-");
+        }
+        printf(" %10d\n", slot_size[place]);
+    }
+    printf("Slot size: the smallest distance between per-thread data that stays "
+           "within %.0f%% of private lines\n", (SLOWDOWN_LIMIT - 1) * 100);
+
+// --- 5. Free Memory ---
+    if (csv)
+        fclose(csv);
+    free(buffer);
+    free(cpus);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,49 @@
+#!/bin/bash
+set -euo pipefail #-e:exit on error | -u:treat unset variables as an error | -o pipefail treat unset variables as an error
+IFS=$'\n\t' #This defines how Bash splits words when expanding variables, reading files, etc.
+
+# ==============================================================================
+# BENCHMARK SCRIPT: COST OF A SHARED CACHE LINE
+# Runs the sweep a few times and appends every case to one csv file per
+# machine, so the tables of different machines can be compared.
+# ==============================================================================
+
+# --- Configuration (Global Constants) ---
+readonly SOURCE="cache_line_bench.c"
+readonly EXECUTABLE="./cl_bench"
+readonly TOPOLOGY_SRC="../../helpers/topology.c"
+readonly RUNS=3
+
+# Input validation
+if [ $# -ne 1 ]; then
+    echo "Usage: $0 <iterations>" >&2
+    exit 1
+fi
+
+readonly CSV_FILE="cache_line_$(hostname).csv"
+
+echo "======================================================"
+echo " --> Compiling: $SOURCE"
+echo "======================================================"
+if ! gcc -O2 -o "$EXECUTABLE" "$SOURCE" "$TOPOLOGY_SRC" -lpthread; then
+    echo "--> Compilation of $SOURCE FAILED." >&2
+    exit 1
+fi
+
+if [ ! -f "$CSV_FILE" ]; then
+    echo "host,line_size,placement,cpu_a,cpu_b,stride,write_every,ns_per_iter,extra_ns_per_write" > "$CSV_FILE"
+fi
+
+for ((run=1; run<=RUNS; run++)); do
+    echo "--- Run $run of $RUNS ---"
+    "$EXECUTABLE" "$1" "$CSV_FILE"
+done
+
+echo "======================================================"
+echo "--> Results appended to $CSV_FILE"
+echo "======================================================"
+
+# --- Cleanup ---
+if [ -f "$EXECUTABLE" ]; then
+    rm "$EXECUTABLE"
+fi
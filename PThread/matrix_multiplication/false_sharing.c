@@ -8,7 +8,7 @@
  *     Elapsed time for the computation
  *
  * Compile:  
- *     1. gcc -Wall -o executable false_sharing.c ../../helpers/matrix_mul_helpers -lpthread
+ *     1. gcc -Wall -o executable false_sharing.c ../../helpers/matrix_mul_helpers ../../helpers/my_rand.c ../../helpers/mtx_alloc.c -lpthread
  *     2. make build SRC=false_sharing.c
  * Usage:
  *     1. ./executable <m> <n> <p> <thread_number>
@@ -35,6 +35,7 @@
 #include <stdlib.h>
 #include <pthread.h>
 #include "../../helpers/timer.h"
+#include "../../helpers/mtx_alloc.h"
 #include "helpers/matrix_mul_helpers.h"
 
 /* ------------------ Global Variables ------------------ */
@@ -89,15 +90,17 @@ int main(int argc, char *argv[]){
     }
 // --- 2. Allocate Matrices ---
     GET_TIME(start);
-    A = malloc(m * n * sizeof(double));
-    B = malloc(n * p * sizeof(double));
-    C = malloc(m * p * sizeof(double));
-    GET_TIME(finish);
-    printf("Elapsed initialization time = %e seconds\n", finish - start);
+    A = mtx_alloc((size_t)m * n * sizeof(double));
+    B = mtx_alloc((size_t)n * p * sizeof(double));
+    C = mtx_alloc((size_t)m * p * sizeof(double));
 
 // --- 3.  Generate Random Matrices --- 
-    gen_matrix(A, m, n);
-    gen_matrix(B, n, p);
+// Each thread first-touches the rows it will later compute on
+    gen_matrix_parallel(A, m, n, thread_count);
+    gen_matrix_parallel(B, n, p, thread_count);
+    touch_matrix(C, m, p, thread_count, 0);
+    GET_TIME(finish);
+    printf("Elapsed initialization time = %e seconds\n", finish - start);
 
 // --- 4. Create Threads and Join Threads --- 
     pthread_t *thread_handles = malloc(thread_count * sizeof(pthread_t));
@@ -111,7 +114,7 @@ int main(int argc, char *argv[]){
     GET_TIME(finish);
 
 // Uncomment for comparison
-    // D = malloc(m * p * sizeof(double)); // for serial code
+    // D = mtx_alloc((size_t)m * p * sizeof(double)); // for serial code
     // serial_product_computation(A, B, D, m, n, p); // This is the serial multiplication , to check that results are the same , and to compare time
     // if(!results_validation(m*p, C, D)){
     //      fprintf(stderr, " The parallel matrix product is wrong");
@@ -119,10 +122,12 @@ int main(int argc, char *argv[]){
     // }
     printf("Parallel Execution Time: %e seconds\n", finish - start);
 
+    mtx_alloc_report();
+
 // --- 5. Free Memory --- 
-    free(A);
-    free(B);
-    free(C);
+    mtx_free(A);
+    mtx_free(B);
+    mtx_free(C);
     free(thread_handles);
 
     return EXIT_SUCCESS;
@@ -1,8 +1,22 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <limits.h>
+#include <pthread.h>
 
 #include "../../../helpers/timer.h"
+#include "../../../helpers/my_rand.h"
+#include "matrix_mul_helpers.h"
+
+/* Arguments of a first-touch worker: the block of rows it owns */
+typedef struct{
+    double *A;
+    int m, n;
+    int first_row, last_row;
+    int random; // 1: random values, 0: zeros
+}touch_args;
+
+static void *touch_rows(void *data);
 
 
 /* -------------------- Usage / Help -------------------- */
@@ -44,6 +58,58 @@ void gen_matrix(double A[], int m, int n){
             A[i * n + j] = random() / ((double)RAND_MAX);
 } 
 
+/* -------------- First-Touch Worker -------------- 
+ * Every row gets its own seed, so the matrix is the same for any 
+ * number of threads.
+ */
+static void *touch_rows(void *data){
+    touch_args *args = (touch_args *)data;
+
+    for (int i = args->first_row; i < args->last_row; i++){
+        double *row = &args->A[(long)i * args->n];
+        unsigned seed = my_seed(i);
+
+        if (args->random)
+            for (int j = 0; j < args->n; j++)
+                row[j] = my_rand(&seed) / ((double)UINT_MAX);
+        else
+            for (int j = 0; j < args->n; j++)
+                row[j] = 0.0;
+    }
+    return NULL;
+}
+
+/* ------------ Parallel First-Touch Initialization ------------ 
+ * Rows are split in the same blocks the product threads use 
+ * (m / thread_count, remainder to the last thread), so each page 
+ * is first written, and therefore placed on the NUMA node, by the 
+ * thread that computes on it. random = 0 only zeroes the rows.
+ */
+void touch_matrix(double A[], int m, int n, int thread_count, int random){
+    pthread_t *handles = malloc(thread_count * sizeof(pthread_t));
+    touch_args *args = malloc(thread_count * sizeof(touch_args));
+    int local_m = m / thread_count;
+
+    for (int t = 0; t < thread_count; t++){
+        args[t].A = A;
+        args[t].m = m;
+        args[t].n = n;
+        args[t].first_row = t * local_m;
+        args[t].last_row = (t == thread_count - 1) ? m : args[t].first_row + local_m;
+        args[t].random = random;
+        pthread_create(&handles[t], NULL, touch_rows, &args[t]);
+    }
+    for (int t = 0; t < thread_count; t++)
+        pthread_join(handles[t], NULL);
+
+    free(handles);
+    free(args);
+}
+
+void gen_matrix_parallel(double A[], int m, int n, int thread_count){
+    touch_matrix(A, m, n, thread_count, 1);
+}
+
 /* -------------- Serial Matrix Multiplication -------------- */
 void serial_product_computation(double A[], double B[], double D[], int n, int m, int p){
     double start, finish;
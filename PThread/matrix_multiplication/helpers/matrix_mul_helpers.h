@@ -5,6 +5,8 @@ void usage(char *prog_name);
 int results_validation(int n, double x[], double x0[]);
 void print_matrix(char *title, double A[], int m, int n);
 void gen_matrix(double A[], int m, int n);
+void gen_matrix_parallel(double A[], int m, int n, int thread_count);
+void touch_matrix(double A[], int m, int n, int thread_count, int random);
 void serial_product_computation();
 
 
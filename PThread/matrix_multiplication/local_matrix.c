@@ -7,7 +7,7 @@
  *     Elapsed time for the initialization
  *     Elapsed time for the computation
  * Compile:  
- *     1. gcc -g -Wall -o executable local_matrix.c ../../helpers/matrix_mul_helpers -lpthread
+ *     1. gcc -g -Wall -o executable local_matrix.c ../../helpers/matrix_mul_helpers ../../helpers/my_rand.c ../../helpers/mtx_alloc.c -lpthread
  *     2. make build SRC=local_matrix.c
  * Usage:
  *     1. ./executable <thread_count> <m> <n> <p> <thread_number>
@@ -31,6 +31,7 @@
 #include <pthread.h>
 #include <string.h>
 #include "../../helpers/timer.h"
+#include "../../helpers/mtx_alloc.h"
 #include "helpers/matrix_mul_helpers.h"
 
 /* ------------------ Global Variables ------------------ */
@@ -51,7 +52,7 @@ void *parallel_product_computation(void *rank){
     long int local_m = m / thread_count; // how many lines i need to take care
     int my_first_row = my_rank * local_m;
     int my_last_row = my_first_row + local_m;
-    double *my_A = malloc(local_m * n * sizeof(double));
+    double *my_A = mtx_alloc((size_t)local_m * n * sizeof(double));
 
     // GET_TIME(start)
     for (int i = my_first_row; i < my_last_row; i++)
@@ -70,7 +71,7 @@ void *parallel_product_computation(void *rank){
     pthread_mutex_unlock(&mutex_p);
     // GET_TIME(finish)
     // printf("Thread %ld > Elapsed time = %e seconds\n", my_rank, finish - start);
-    free(my_A);
+    mtx_free(my_A);
 
     return NULL;
 }
@@ -97,15 +98,17 @@ int main(int argc, char *argv[]){
 
 // --- 2. Allocate Matrices ---
     GET_TIME(start);
-    A = malloc(m * n * sizeof(double));
-    B = malloc(n * p * sizeof(double));
-    C = malloc(m * p * sizeof(double));
-    GET_TIME(finish);
-    printf("Elapsed initializon time = %e seconds\n", finish - start);
+    A = mtx_alloc((size_t)m * n * sizeof(double));
+    B = mtx_alloc((size_t)n * p * sizeof(double));
+    C = mtx_alloc((size_t)m * p * sizeof(double));
 
 // --- 3.  Generate Random Matrices ---     
-    gen_matrix(A, m, n);
-    gen_matrix(B, n, p);
+// Each thread first-touches the rows it will later compute on
+    gen_matrix_parallel(A, m, n, thread_count);
+    gen_matrix_parallel(B, n, p, thread_count);
+    touch_matrix(C, m, p, thread_count, 0);
+    GET_TIME(finish);
+    printf("Elapsed initializon time = %e seconds\n", finish - start);
     
 // --- 4. Create Threads and Join Threads --- 
     pthread_t *thread_handles = malloc(thread_count * sizeof(pthread_t));
@@ -118,7 +121,7 @@ int main(int argc, char *argv[]){
     GET_TIME(finish);
 
 // Uncomment for comparison
-    // D = malloc(m * p * sizeof(double)); // for serial code
+    // D = mtx_alloc((size_t)m * p * sizeof(double)); // for serial code
     // serial_product_computation(A, B, D, m, n, p); // This is the serial multiplication , to check that results are the same , and to compare time
     // if(!results_validation(m*p, C, D)){
     //      fprintf(stderr, " The parallel matrix product is wrong");
@@ -127,11 +130,13 @@ int main(int argc, char *argv[]){
 
     printf("Parallel Execution Time: %e seconds\n", finish - start);  
         
+    mtx_alloc_report();
+
 // --- 5. Free Memory & Destroy Mutex --- 
     pthread_mutex_destroy(&mutex_p);
-    free(A);
-    free(B);
-    free(C);
+    mtx_free(A);
+    mtx_free(B);
+    mtx_free(C);
     
     return EXIT_SUCCESS;
 }
\ No newline at end of file
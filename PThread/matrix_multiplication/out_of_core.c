@@ -0,0 +1,380 @@
+/* Purpose:
+ *     Computes a parallel matrix-matrix product(m x n)(n x p) when A, B
+ *     and C do not fit in memory. The matrices live in files and are
+ *     streamed through a bounded memory budget in tiles. A random
+ *     number generator is used to generate the matrix files.
+ * Output:
+ *     Elapsed time for the generation of the files
+ *     Elapsed time for the computation (including the I/O)
+ *     Time the compute threads spent waiting for tiles
+ *
+ * Compile:
+ *     1. gcc -Wall -o executable out_of_core.c helpers/matrix_mul_helpers.c ../../helpers/my_rand.c ../../helpers/mtx_alloc.c -lpthread
+ *     2. make build SRC=out_of_core.c
+ * Usage:
+ *     1. ./executable <m> <n> <p> <thread_number> [memory_MB]
+ *     2. make run m=<m> n=<n> p=<p> t=<thread_number> mem=<memory_MB>
+ *     The files are written in the directory given by the OOC_DIR
+ *     environment variable (default: current directory) and removed
+ *     at the end.
+ * Notes:
+ *     C is computed one row panel (tm rows) at a time. For every panel
+ *     the k dimension is walked in blocks of tk: a tile of A (tm x tk)
+ *     and a tile of B (tk x p) are read with pread and multiplied into
+ *     the panel, which is written back with pwrite when it is complete.
+ *     A background I/O thread reads the next pair of tiles into a second
+ *     buffer while the compute threads work on the current one (double
+ *     buffering), so the cores keep busy while the disk works.
+ *     tm = tk is the largest size for which the C panel and the two
+ *     buffers fit in memory_MB (default 256).
+ *     Compile with -DDEBUG to check C against the serial product.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../../helpers/timer.h"
+#include "../../helpers/mtx_alloc.h"
+#include "../../helpers/my_rand.h"
+#include "helpers/matrix_mul_helpers.h"
+
+#define DEFAULT_MEMORY_MB 256
+
+/* ------------------ Tile Buffer ------------------ */
+typedef struct{
+    double *A_tile;        // tm x tk, row-major
+    double *B_tile;        // tk x p, row-major
+    int panel, k_block;    // which tiles are in the buffer
+    int rows, depth;       // actual tm/tk (the last blocks can be smaller)
+    int full;              // 1: filled by the I/O thread, 0: free
+}tile_buffer;
+
+/* ------------------ Global Variables ------------------ */
+int thread_count;
+int m, n, p;
+int tm, tk;                    // tile sizes
+int panels, k_blocks;
+int fd_A, fd_B, fd_C;
+double *C_panel;               // tm x p accumulation panel
+tile_buffer buffers[2];
+tile_buffer *current;          // tile the compute threads work on
+pthread_mutex_t buffer_mtx;
+pthread_cond_t buffer_full, buffer_free;
+pthread_barrier_t tile_ready, tile_done;
+int finished = 0;
+
+/* ----------------- Function Prototypes ----------------- */
+void *io_task(void *unused);
+void *compute_task(void *rank);
+void write_matrix_file(int fd, int rows, int cols, unsigned stream);
+void read_full(int fd, void *buf, size_t bytes, off_t offset);
+void write_full(int fd, const void *buf, size_t bytes, off_t offset);
+int open_matrix_file(const char *dir, const char *name, char *path);
+void choose_tiles(long memory_mb);
+
+/* ----------------- Full pread / pwrite -----------------
+ * pread/pwrite can return less than asked, so loop until done.
+ */
+void read_full(int fd, void *buf, size_t bytes, off_t offset){
+    char *ptr = buf;
+    while (bytes > 0){
+        ssize_t got = pread(fd, ptr, bytes, offset);
+        if (got <= 0){
+            perror("pread failed");
+            exit(EXIT_FAILURE);
+        }
+        ptr += got;
+        bytes -= got;
+        offset += got;
+    }
+}
+
+void write_full(int fd, const void *buf, size_t bytes, off_t offset){
+    const char *ptr = buf;
+    while (bytes > 0){
+        ssize_t put = pwrite(fd, ptr, bytes, offset);
+        if (put <= 0){
+            perror("pwrite failed");
+            exit(EXIT_FAILURE);
+        }
+        ptr += put;
+        bytes -= put;
+        offset += put;
+    }
+}
+
+/* ----------------- Matrix Files ----------------- */
+int open_matrix_file(const char *dir, const char *name, char *path){
+    snprintf(path, PATH_MAX, "%s/%s", dir, name);
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0){
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    return fd;
+}
+
+/* Generates the matrix one row at a time, so it never has to fit in
+ * memory. Row i uses the stream my_seed(stream + i). */
+void write_matrix_file(int fd, int rows, int cols, unsigned stream){
+    double *row = malloc(cols * sizeof(double));
+
+    for (int i = 0; i < rows; i++){
+        unsigned seed = my_seed(stream + i);
+        for (int j = 0; j < cols; j++)
+            row[j] = my_rand(&seed) / ((double)UINT_MAX);
+        write_full(fd, row, cols * sizeof(double), (off_t)i * cols * sizeof(double));
+    }
+    free(row);
+}
+
+/* ----------------- Tile Sizes -----------------
+ * With tm = tk = T the memory needed is T*p (C panel) plus
+ * 2*(T*T + T*p) (two buffers), i.e. 2T^2 + 3pT doubles.
+ */
+void choose_tiles(long memory_mb){
+    double budget = (double)memory_mb * 1024 * 1024 / sizeof(double);
+    long T = (long)((-3.0 * p + sqrt(9.0 * p * p + 8.0 * budget)) / 4.0);
+
+    if (T < 1){
+        fprintf(stderr, "Error: %ld MB is not enough for a single row of tiles.\n", memory_mb);
+        exit(EXIT_FAILURE);
+    }
+    tm = (T < m) ? T : m;
+    tk = (T < n) ? T : n;
+    panels = (m + tm - 1) / tm;
+    k_blocks = (n + tk - 1) / tk;
+}
+
+/* ------------------ Background I/O Thread ------------------
+ * Reads the tiles in the order the compute threads need them,
+ * alternating between the two buffers.
+ */
+void *io_task(void *unused){
+    int slot = 0;
+
+    for (int panel = 0; panel < panels; panel++)
+        for (int kb = 0; kb < k_blocks; kb++){
+            tile_buffer *buf = &buffers[slot];
+
+            pthread_mutex_lock(&buffer_mtx);
+            while (buf->full)
+                pthread_cond_wait(&buffer_free, &buffer_mtx);
+            pthread_mutex_unlock(&buffer_mtx);
+
+            int first_row = panel * tm;
+            int first_k = kb * tk;
+            buf->panel = panel;
+            buf->k_block = kb;
+            buf->rows = (first_row + tm <= m) ? tm : m - first_row;
+            buf->depth = (first_k + tk <= n) ? tk : n - first_k;
+
+// A tile: one strided read per row (one contiguous read if tk == n)
+            if (buf->depth == n)
+                read_full(fd_A, buf->A_tile, (size_t)buf->rows * n * sizeof(double),
+                          (off_t)first_row * n * sizeof(double));
+            else
+                for (int i = 0; i < buf->rows; i++)
+                    read_full(fd_A, &buf->A_tile[(long)i * buf->depth], buf->depth * sizeof(double),
+                              ((off_t)(first_row + i) * n + first_k) * sizeof(double));
+// B tile: tk consecutive rows
+            read_full(fd_B, buf->B_tile, (size_t)buf->depth * p * sizeof(double),
+                      (off_t)first_k * p * sizeof(double));
+
+            pthread_mutex_lock(&buffer_mtx);
+            buf->full = 1;
+            pthread_cond_signal(&buffer_full);
+            pthread_mutex_unlock(&buffer_mtx);
+
+            slot = 1 - slot;
+        }
+    return NULL;
+}
+
+/* ------------------ Compute Threads ------------------
+ * Each thread owns a block of rows of the panel and accumulates
+ * A_tile * B_tile into them (i-k-j order, unit stride on B and C).
+ */
+void *compute_task(void *rank){
+    long my_rank = (long)rank;
+
+    while (1){
+        pthread_barrier_wait(&tile_ready);
+        if (finished)
+            break;
+
+        tile_buffer *buf = current;
+        int local_rows = (buf->rows + thread_count - 1) / thread_count;
+        int my_first_row = my_rank * local_rows;
+        int my_last_row = my_first_row + local_rows;
+        if (my_last_row > buf->rows)
+            my_last_row = buf->rows;
+
+        for (int i = my_first_row; i < my_last_row; i++){
+            double *c_row = &C_panel[(long)i * p];
+            for (int kk = 0; kk < buf->depth; kk++){
+                double a = buf->A_tile[(long)i * buf->depth + kk];
+                double *b_row = &buf->B_tile[(long)kk * p];
+                for (int j = 0; j < p; j++)
+                    c_row[j] += a * b_row[j];
+            }
+        }
+        pthread_barrier_wait(&tile_done);
+    }
+    return NULL;
+}
+
+/* ---------------------------- Usage ---------------------------- */
+/* The common usage() plus the memory budget */
+static void usage_out_of_core(char *prog_name){
+    fprintf(stderr, "Usage: %s <m> <n> <p> <thread_count> [memory_MB]\n", prog_name);
+    fprintf(stderr, "  memory_MB  budget for the tiles and the C panel (default %d)\n", DEFAULT_MEMORY_MB);
+    exit(0);
+}
+
+/* ---------------------------- Main Function ---------------------------- */
+int main(int argc, char *argv[]){
+    double start, finish, wait_start, wait_finish, io_wait = 0.0;
+    char path_A[PATH_MAX], path_B[PATH_MAX], path_C[PATH_MAX];
+
+// --- 1. Argument Validation and Parsing ---
+    if (argc != 5 && argc != 6) usage_out_of_core(argv[0]);
+
+    m = strtol(argv[1], NULL, 10);
+    n = strtol(argv[2], NULL, 10);
+    p = strtol(argv[3], NULL, 10);
+    thread_count = strtol(argv[4], NULL, 10);
+    long memory_mb = (argc == 6) ? strtol(argv[5], NULL, 10) : DEFAULT_MEMORY_MB;
+    const char *dir = getenv("OOC_DIR") ? getenv("OOC_DIR") : ".";
+
+    if (m <= 0 || n <= 0 || p <= 0 || thread_count <= 0 || memory_mb <= 0) usage_out_of_core(argv[0]);
+    choose_tiles(memory_mb);
+    printf("Tiles: %d x %d (A), %d x %d (B), %d panels x %d blocks, budget %ld MB\n",
+           tm, tk, tk, p, panels, k_blocks, memory_mb);
+
+// --- 2. Generate the Matrix Files ---
+    GET_TIME(start);
+    fd_A = open_matrix_file(dir, "ooc_A.bin", path_A);
+    fd_B = open_matrix_file(dir, "ooc_B.bin", path_B);
+    fd_C = open_matrix_file(dir, "ooc_C.bin", path_C);
+    write_matrix_file(fd_A, m, n, 0);
+    write_matrix_file(fd_B, n, p, m);
+    GET_TIME(finish);
+    printf("Elapsed generation time = %e seconds\n", finish - start);
+
+// --- 3. Allocate the Panel and the Two Tile Buffers ---
+    C_panel = mtx_alloc((size_t)tm * p * sizeof(double));
+    for (int b = 0; b < 2; b++){
+        buffers[b].A_tile = mtx_alloc((size_t)tm * tk * sizeof(double));
+        buffers[b].B_tile = mtx_alloc((size_t)tk * p * sizeof(double));
+        buffers[b].full = 0;
+        if (!buffers[b].A_tile || !buffers[b].B_tile){
+            fprintf(stderr, "Memory allocation failed.\n");
+            return EXIT_FAILURE;
+        }
+    }
+    if (!C_panel){
+        fprintf(stderr, "Memory allocation failed.\n");
+        return EXIT_FAILURE;
+    }
+    pthread_mutex_init(&buffer_mtx, NULL);
+    pthread_cond_init(&buffer_full, NULL);
+    pthread_cond_init(&buffer_free, NULL);
+    pthread_barrier_init(&tile_ready, NULL, thread_count + 1);
+    pthread_barrier_init(&tile_done, NULL, thread_count + 1);
+
+// --- 4. Create Threads, Stream the Tiles, Join Threads ---
+    pthread_t io_handle;
+    pthread_t *thread_handles = malloc(thread_count * sizeof(pthread_t));
+
+    GET_TIME(start);
+    pthread_create(&io_handle, NULL, io_task, NULL);
+    for (long thread = 0; thread < thread_count; thread++)
+        pthread_create(&thread_handles[thread], NULL, compute_task, (void *)thread);
+
+    int slot = 0;
+    for (int panel = 0; panel < panels; panel++){
+        int rows = (panel * tm + tm <= m) ? tm : m - panel * tm;
+        memset(C_panel, 0, (size_t)rows * p * sizeof(double));
+
+        for (int kb = 0; kb < k_blocks; kb++){
+            tile_buffer *buf = &buffers[slot];
+
+            GET_TIME(wait_start);
+            pthread_mutex_lock(&buffer_mtx);
+            while (!buf->full)
+                pthread_cond_wait(&buffer_full, &buffer_mtx);
+            pthread_mutex_unlock(&buffer_mtx);
+            GET_TIME(wait_finish);
+            io_wait += wait_finish - wait_start;
+
+// While the threads compute on this buffer the I/O thread fills the other
+            current = buf;
+            pthread_barrier_wait(&tile_ready);
+            pthread_barrier_wait(&tile_done);
+
+            pthread_mutex_lock(&buffer_mtx);
+            buf->full = 0;
+            pthread_cond_signal(&buffer_free);
+            pthread_mutex_unlock(&buffer_mtx);
+            slot = 1 - slot;
+        }
+        write_full(fd_C, C_panel, (size_t)rows * p * sizeof(double),
+                   (off_t)panel * tm * p * sizeof(double));
+    }
+    finished = 1;
+    pthread_barrier_wait(&tile_ready);
+
+    for (long thread = 0; thread < thread_count; thread++)
+        pthread_join(thread_handles[thread], NULL);
+    pthread_join(io_handle, NULL);
+    GET_TIME(finish);
+
+    printf("Parallel Execution Time: %e seconds\n", finish - start);
+    printf("Waiting for I/O: %e seconds\n", io_wait);
+
+#ifdef DEBUG
+    double *A = mtx_alloc((size_t)m * n * sizeof(double));
+    double *B = mtx_alloc((size_t)n * p * sizeof(double));
+    double *C = mtx_alloc((size_t)m * p * sizeof(double));
+    double *D = mtx_alloc((size_t)m * p * sizeof(double));
+    read_full(fd_A, A, (size_t)m * n * sizeof(double), 0);
+    read_full(fd_B, B, (size_t)n * p * sizeof(double), 0);
+    read_full(fd_C, C, (size_t)m * p * sizeof(double), 0);
+    serial_product_computation(A, B, D, n, m, p);
+    if (!results_validation(m * p, C, D))
+        fprintf(stderr, "The out-of-core matrix product is wrong\n");
+    mtx_free(A);
+    mtx_free(B);
+    mtx_free(C);
+    mtx_free(D);
+#endif
+
+    mtx_alloc_report();
+
+// --- 5. Free Memory & Remove the Files ---
+    pthread_barrier_destroy(&tile_ready);
+    pthread_barrier_destroy(&tile_done);
+    pthread_cond_destroy(&buffer_full);
+    pthread_cond_destroy(&buffer_free);
+    pthread_mutex_destroy(&buffer_mtx);
+    for (int b = 0; b < 2; b++){
+        mtx_free(buffers[b].A_tile);
+        mtx_free(buffers[b].B_tile);
+    }
+    mtx_free(C_panel);
+    free(thread_handles);
+    close(fd_A);
+    close(fd_B);
+    close(fd_C);
+    unlink(path_A);
+    unlink(path_B);
+    unlink(path_C);
+
+    return EXIT_SUCCESS;
+}
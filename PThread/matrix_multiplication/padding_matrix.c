@@ -7,11 +7,14 @@
  *     Elapsed time for the initialization
  *     Elapsed time for the computation(Serial or Parallel)
  * Compile:  
- *     1. gcc -Wall -o executable padding_matrix.c ../../helpers/matrix_mul_helpers -lpthread
+ *     1. gcc -Wall -o executable padding_matrix.c ../../helpers/matrix_mul_helpers ../../helpers/my_rand.c ../../helpers/mtx_alloc.c ../../helpers/tuning.c ../../helpers/topology.c -lpthread -lm
  *     2. make build SRC=padding_matrix.c
  * Usage:
  *     1. ./executable <thread_count> <m> <n> <p> <thread_number>
  *     2. make run m=<m> n=<n> p=<p> t=<thread_number>
+ *     thread_number 0 uses the thread count and padding stored in
+ *     tuning.cache for this machine and size class, and searches for
+ *     them (storing the winner) when there is no entry.
  * Aggregate Results:
  *     Use results.sh script to run the source code multiple times for threads 1-8 
  *     and get aggregated execution time results
@@ -31,28 +34,36 @@
 #include <pthread.h>
 #include <math.h>
 #include "../../helpers/timer.h"
+#include "../../helpers/mtx_alloc.h"
+#include "../../helpers/tuning.h"
+#include "../../helpers/topology.h"
 #include "helpers/matrix_mul_helpers.h"
 
 /* --- Define Padding Constants --- */
-// Cache line size in bytes (e.g., 64 bytes)
-#define CACHE_LINE_SIZE 64 
 // Size of a double (8 bytes)
 #define DOUBLE_SIZE sizeof(double)
 
-// Calculate how many extra doubles are needed to pad to the next cache line boundary
-// The row size must be a multiple of CACHE_LINE_SIZE / DOUBLE_SIZE (which is 8 doubles)
-#define PADDING_DOUBLES (CACHE_LINE_SIZE / DOUBLE_SIZE)
+// The row size must be a multiple of the cache line size in doubles. The
+// line size is read from sysfs (topo_line_size), e.g. 64 bytes: 8 doubles
+
+// Autotuning: best of TUNE_REPS runs for every candidate
+#define TUNE_REPS 2
 
 /* ------------------ Global Variables ------------------ */
 int thread_count;
 int m, n, p;
 // PADDED_P will store the new, padded column dimension for matrix C
 int PADDED_P; 
+// Rows of C are padded to a multiple of padding_doubles (tunable),
+// one cache line by default
+int padding_doubles;
 double *A, *B, *C;
 double start, finish;
 
 /* ----------------- Function Prototypes ----------------- */
 void *parallel_product_computation(void *rank);
+double run_product(void);
+void autotune(void);
 
 /* -------------- Parallel Matrix Multiplication with Data Padding -------------- */
 void *parallel_product_computation(void *rank){
@@ -62,8 +73,10 @@ void *parallel_product_computation(void *rank){
     int my_last_row = my_first_row + local_m;
 
     double temp;
+// Uncomment to debug per-thread timing (local, the globals time the whole product)
+    // double my_start, my_finish;
 
-    GET_TIME(start);
+    // GET_TIME(my_start);
     for (int i = my_first_row; i < my_last_row; i++){
 // Use PADDED_P for indexing matrix C
         for (int k = 0; k < p; k++) {
@@ -75,12 +88,86 @@ void *parallel_product_computation(void *rank){
             }
         }
     }
-    GET_TIME(finish);
-    // printf("Thread %ld > Elapsed time = %e seconds\n", my_rank, finish - start);
+    // GET_TIME(my_finish);
+    // printf("Thread %ld > Elapsed time = %e seconds\n", my_rank, my_finish - my_start);
 
     return NULL;
 }
 
+/* -------------- Create and Join the Threads -------------- 
+ * C must be allocated for the current PADDED_P.
+ */
+double run_product(void){
+    pthread_t *thread_handles = malloc(thread_count * sizeof(pthread_t));
+    double run_start, run_finish;
+
+    GET_TIME(run_start);
+    for (long thread = 0; thread < thread_count; thread++)
+        pthread_create(&thread_handles[thread], NULL, parallel_product_computation, (void *)thread);
+
+    for (long thread = 0; thread < thread_count; thread++)
+        pthread_join(thread_handles[thread], NULL);
+    GET_TIME(run_finish);
+
+    free(thread_handles);
+    return run_finish - run_start;
+}
+
+/* -------------- Autotuning of Threads and Padding -------------- 
+ * Loads thread_count and padding_doubles from the tuning cache, or 
+ * times every power-of-two thread count up to the number of cpus, and
+ * the number of cpus itself, that divides m with every padding and
+ * stores the fastest. The entry is shared by the whole size class: a
+ * cached count that does not divide m drops to the largest one that does.
+ */
+void autotune(void){
+    const int paddings[] = {1, 4, 8, 16};
+    char size_class[TUNE_CLASS_LEN];
+    long dims[3] = {m, n, p};
+    tune_config best = {0};
+    double best_time = -1.0;
+
+    tune_class(size_class, dims, 3);
+    if (tune_load("padding_matrix", size_class, &best)){
+        tune_print("Tuning cache", &best);
+    }
+    else{
+        int max_threads = tune_max_threads();
+
+        for (thread_count = 1; thread_count <= max_threads;
+             thread_count = (thread_count * 2 > max_threads && thread_count < max_threads) ? max_threads : thread_count * 2){
+            if (m % thread_count != 0)
+                continue;
+            for (int i = 0; i < 4; i++){
+                PADDED_P = (p + paddings[i] - 1) / paddings[i] * paddings[i];
+                C = mtx_alloc((size_t)m * PADDED_P * sizeof(double));
+                touch_matrix(C, m, PADDED_P, thread_count, 0);
+
+                double elapsed = -1.0;
+                for (int rep = 0; rep < TUNE_REPS; rep++){
+                    double t = run_product();
+                    if (elapsed < 0 || t < elapsed)
+                        elapsed = t;
+                }
+                if (best_time < 0 || elapsed < best_time){
+                    best_time = elapsed;
+                    tune_set(&best, "threads", thread_count);
+                    tune_set(&best, "padding", paddings[i]);
+                }
+                mtx_free(C);
+            }
+        }
+        tune_store("padding_matrix", size_class, &best, best_time);
+        tune_print("Autotuned", &best);
+    }
+    thread_count = tune_get(&best, "threads", 1);
+    if (thread_count < 1)
+        thread_count = 1;
+    while (m % thread_count != 0)
+        thread_count--;
+    padding_doubles = tune_get(&best, "padding", padding_doubles);
+}
+
 /* ---------------------------- Main Function ---------------------------- */
 int main(int argc, char *argv[]){
 // --- 1. Argument Validation and Parsing ---
@@ -90,52 +177,61 @@ int main(int argc, char *argv[]){
     n = strtol(argv[2], NULL, 10);
     p = strtol(argv[3], NULL, 10);
     thread_count = strtol(argv[4], NULL, 10);
+    int tuning = (thread_count == 0);
+    padding_doubles = topo_line_size() / DOUBLE_SIZE;
     
-    if (m % thread_count != 0){
+    if (tuning){
+// The search needs the matrices, so they are generated with all the cpus
+        A = mtx_alloc((size_t)m * n * sizeof(double));
+        B = mtx_alloc((size_t)n * p * sizeof(double));
+        gen_matrix_parallel(A, m, n, tune_max_threads());
+        gen_matrix_parallel(B, n, p, tune_max_threads());
+        autotune();
+    }
+
+    if (thread_count <= 0 || m % thread_count != 0){
         fprintf(stderr, "Error: The threads number should evenly divide the number of rows (m).\n");
         exit(EXIT_FAILURE);
     }
     
 // --- DETERMINE PADDED_P ---
 // Calculate the padded column dimension for C (PADDED_P)
-// Find the next multiple of PADDING_DOUBLES that is >= p
-    PADDED_P = (p + PADDING_DOUBLES - 1) / PADDING_DOUBLES * PADDING_DOUBLES;
+// Find the next multiple of padding_doubles that is >= p
+    PADDED_P = (p + padding_doubles - 1) / padding_doubles * padding_doubles;
 
 // --- 2. Allocate Matrices with Padding for C ---
     GET_TIME(start);
-    A = malloc(m * n * sizeof(double));
-    B = malloc(n * p * sizeof(double));
+    if (!tuning){
+        A = mtx_alloc((size_t)m * n * sizeof(double));
+        B = mtx_alloc((size_t)n * p * sizeof(double));
+    }
     // Allocate C using the padded column count: m x PADDED_P
-    C = malloc(m * PADDED_P * sizeof(double)); 
-    GET_TIME(finish);
-    printf("Elapsed initialization time = %e seconds\n", finish - start);
+    C = mtx_alloc((size_t)m * PADDED_P * sizeof(double)); 
     // Display padding information
     printf("Original P (columns): %d, Padded P: %d, Padding Doubles per row: %d\n", 
            p, PADDED_P, PADDED_P - p);
 
 // --- 3.  Generate Random Matrices --- 
-    gen_matrix(A, m, n);
-    gen_matrix(B, n, p);
-    // Note: C is allocated larger, but Gen_matrix doesn't need C.
+// Each thread first-touches the rows it will later compute on
+    if (!tuning){
+        gen_matrix_parallel(A, m, n, thread_count);
+        gen_matrix_parallel(B, n, p, thread_count);
+    }
+    touch_matrix(C, m, PADDED_P, thread_count, 0);
+    GET_TIME(finish);
+    printf("Elapsed initialization time = %e seconds\n", finish - start);
 
 // --- 4. Create Threads and Join Threads --- 
-    pthread_t *thread_handles = malloc(thread_count * sizeof(pthread_t));
+    double elapsed = run_product();
 
-    GET_TIME(start);
-    for (long thread = 0; thread < thread_count; thread++)
-        pthread_create(&thread_handles[thread], NULL, parallel_product_computation, (void *)thread);
+printf("Parallel Execution Time: %e seconds\n", elapsed);
 
-    for (long thread = 0; thread < thread_count; thread++)
-        pthread_join(thread_handles[thread], NULL);
-    GET_TIME(finish);
-
-printf("Parallel Execution Time: %e seconds\n", finish - start);
+    mtx_alloc_report();
 
 // --- 5. Free Memory --- 
-    free(A);
-    free(B);
-    free(C);
-    free(thread_handles);
+    mtx_free(A);
+    mtx_free(B);
+    mtx_free(C);
 
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -11,6 +11,10 @@ IFS=$'\n\t' #This defines how Bash splits words when expanding variables, readin
 readonly PROGRAMS=("false_sharing.c" "padding_matrix.c" "local_matrix.c") 
 readonly EXECUTABLE="./mm_bench" # Single, consistent executable name
 readonly HELPERS_SRC="helpers/matrix_mul_helpers.c"
+readonly RAND_SRC="../../helpers/my_rand.c"
+readonly TUNING_SRC="../../helpers/tuning.c"
+readonly ALLOC_SRC="../../helpers/mtx_alloc.c"
+readonly TOPOLOGY_SRC="../../helpers/topology.c"
 readonly THREADS_START=2
 readonly THREADS=(2 4 8) #Runs for 2, 4, 8 threads (3 iterations)
 readonly RUNS_PER_THREAD=3
@@ -32,7 +36,7 @@ run_benchmark() {
     
     # Compile the source file, checking for errors
     # Using global constants EXECUTABLE and HELPERS_SRC
-    gcc -o "$EXECUTABLE" "$source" "$HELPERS_SRC" -lpthread
+    gcc -o "$EXECUTABLE" "$source" "$HELPERS_SRC" "$RAND_SRC" "$TUNING_SRC" "$ALLOC_SRC" "$TOPOLOGY_SRC" -lpthread -lm
     if [ $? -ne 0 ]; then
         echo "--> Compilation of $source FAILED. Skipping." >&2
         return 1
@@ -0,0 +1,220 @@
+/* Purpose:
+ *   A NUMA-aware reader-writer lock for multi-socket machines (a lock
+ *   cohort): handing the writer lock to a thread of another socket
+ *   moves the lock and the list nodes it protects across the
+ *   interconnect, so a writer hands it to a writer of its own socket
+ *   first, up to COHORT_PASSES times in a row, before it lets it cross.
+ *
+ *   Writer:  takes the local ticket lock of its socket, then the global
+ *            ticket lock, unless the previous local owner passed the
+ *            global one along with it. Then, like scalable_rw.c, it
+ *            raises the writer flag and waits until no reader is in.
+ *   Reader:  counts itself in the counter of its own socket, then checks
+ *            the writer flag. If a writer is there it steps back and
+ *            waits.
+ *
+ * Notes:
+ *   1. The socket of a thread is the package (helpers/topology.c) of
+ *      the cpu it first locks on. Threads are not pinned: a thread that
+ *      moves keeps its socket, which only costs locality.
+ *   2. Both are ticket locks (FIFO, and any thread may release them):
+ *      the writer that releases the global lock is often not the one
+ *      that took it.
+ *   3. Writers have priority: during a run of passes inside a socket
+ *      the writer flag stays up and the readers keep waiting.
+ *   4. At exit it prints, per socket, how often the global lock came
+ *      from the same or another socket and how often it was passed on
+ *      inside the socket.
+ *   5. Build with -DCOHORT_FAKE_SOCKETS=n to spread the threads over n
+ *      sockets by thread_rank, to exercise the handoffs on one socket.
+ *   6. Both sides store, fence (the reader's seq_cst increment is one),
+ *      then load what the other side stored (Dekker style, as in
+ *      scalable_rw.c), so a reader and a writer never both get in.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "../../helpers/topology.h"
+
+#include "globals/helpers.h"
+
+#define CACHE_LINE 64
+#define SPIN_LIMIT 100
+#define MAX_SOCKETS 8
+#define COHORT_PASSES 64  // local handoffs before the lock has to cross
+
+typedef struct{
+    _Atomic unsigned next;   // the ticket of the next arrival
+    _Atomic unsigned owner;  // the ticket being served
+}ticket_lock_s;
+
+typedef struct{
+    ticket_lock_s local;
+    int global_held;         // the previous owner passed the global lock
+    int passes;              // local handoffs in a row
+    long from_same;          // global lock taken after this socket had it
+    long from_other;         // global lock taken from another socket
+    long handoffs;           // passed on inside the socket
+}__attribute__((aligned(CACHE_LINE))) socket_lock_s;
+
+typedef struct{
+    _Atomic long readers;    // readers of this socket in or trying
+}__attribute__((aligned(CACHE_LINE))) socket_readers_s;
+
+static ticket_lock_s global __attribute__((aligned(CACHE_LINE)));
+static _Atomic int writer __attribute__((aligned(CACHE_LINE))) = 0;
+static int last_socket = -1;  // the last socket that held the global lock
+static socket_lock_s sockets[MAX_SOCKETS];
+static socket_readers_s socket_readers[MAX_SOCKETS];
+
+static int socket_count = 1;
+#ifndef COHORT_FAKE_SOCKETS
+static int socket_of_cpu[TOPO_MAX_CPUS];
+#endif
+static pthread_once_t topology_once = PTHREAD_ONCE_INIT;
+static __thread int my_socket = -1;
+
+/* ------------------ Local Helpers ------------------ */
+/* Maps the packages of the online cpus to sockets 0, 1, ... */
+static void Read_topology(void){
+#ifdef COHORT_FAKE_SOCKETS
+    socket_count = COHORT_FAKE_SOCKETS < MAX_SOCKETS ? COHORT_FAKE_SOCKETS : MAX_SOCKETS;
+#else
+    static topo_cpu cpus[TOPO_MAX_CPUS];
+    int packages[MAX_SOCKETS];
+    int ncpus = topo_cpus(cpus, TOPO_MAX_CPUS);
+
+    socket_count = 0;
+    for (int i = 0; i < ncpus; i++){
+        int s = 0;
+
+        while (s < socket_count && packages[s] != cpus[i].package)
+            s++;
+        if (s == socket_count && socket_count < MAX_SOCKETS)
+            packages[socket_count++] = cpus[i].package;
+        socket_of_cpu[cpus[i].cpu] = s < MAX_SOCKETS ? s : s % MAX_SOCKETS;
+    }
+    if (socket_count == 0)
+        socket_count = 1;
+#endif
+}
+
+static int My_socket(void){
+    if (my_socket < 0){
+        pthread_once(&topology_once, Read_topology);
+#ifdef COHORT_FAKE_SOCKETS
+        my_socket = (int)(thread_rank % socket_count);
+#else
+        int cpu = sched_getcpu();
+        my_socket = cpu >= 0 && cpu < TOPO_MAX_CPUS ? socket_of_cpu[cpu] : 0;
+#endif
+    }
+    return my_socket;
+}
+
+static void Ticket_lock(ticket_lock_s *lock){
+    unsigned ticket = atomic_fetch_add(&lock->next, 1);
+    int spins = 0;
+
+    while (atomic_load_explicit(&lock->owner, memory_order_acquire) != ticket){
+        if (++spins > SPIN_LIMIT)
+            sched_yield();
+    }
+}
+
+static void Ticket_unlock(ticket_lock_s *lock){
+    atomic_store_explicit(&lock->owner, atomic_load_explicit(&lock->owner, memory_order_relaxed) + 1,
+                          memory_order_release);
+}
+
+/* The owner only: someone else holds a ticket */
+static int Ticket_waiters(ticket_lock_s *lock){
+    return atomic_load(&lock->next) - atomic_load_explicit(&lock->owner, memory_order_relaxed) > 1;
+}
+
+/* ------------------ Reader Enters / Leaves ------------------ */
+static void Read_lock(void){
+    _Atomic long *mine = &socket_readers[My_socket()].readers;
+    int spins = 0;
+
+    for (;;){
+        atomic_fetch_add(mine, 1);
+        if (!atomic_load(&writer))
+            break;
+// A writer is in or waiting: step back and let it go first
+        atomic_fetch_sub(mine, 1);
+        while (atomic_load_explicit(&writer, memory_order_acquire)){
+            if (++spins > SPIN_LIMIT)
+                sched_yield();
+        }
+    }
+}
+
+static void Read_unlock(void){
+    atomic_fetch_sub_explicit(&socket_readers[my_socket].readers, 1, memory_order_release);
+}
+
+/* ------------------ Writer Enters / Leaves ------------------ */
+static void Write_lock(void){
+    int s = My_socket();
+    socket_lock_s *sock = &sockets[s];
+    int spins = 0;
+
+    Ticket_lock(&sock->local);
+    if (!sock->global_held){
+        Ticket_lock(&global);
+        if (last_socket == s)
+            sock->from_same++;
+        else if (last_socket >= 0)
+            sock->from_other++;
+        last_socket = s;
+    }
+    sock->global_held = 0;
+
+    atomic_store_explicit(&writer, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    for (int i = 0; i < socket_count; i++)
+        while (atomic_load_explicit(&socket_readers[i].readers, memory_order_acquire) != 0){
+            if (++spins > SPIN_LIMIT)
+                sched_yield();
+        }
+}
+
+static void Write_unlock(void){
+    socket_lock_s *sock = &sockets[my_socket];
+
+// A writer of this socket is waiting: pass it the global lock too
+    if (sock->passes < COHORT_PASSES && Ticket_waiters(&sock->local)){
+        sock->passes++;
+        sock->handoffs++;
+        sock->global_held = 1;
+        Ticket_unlock(&sock->local);
+        return;
+    }
+    sock->passes = 0;
+    atomic_store(&writer, 0);
+    Ticket_unlock(&global);
+    Ticket_unlock(&sock->local);
+}
+
+/* ------------------ Report ------------------ */
+static void Report(void){
+    printf("Cohort lock, %d socket(s), up to %d passes inside a socket:\n", socket_count, COHORT_PASSES);
+    printf("%8s %18s %18s %18s\n", "socket", "global from same", "global from other", "passed in socket");
+    for (int s = 0; s < socket_count; s++)
+        printf("%8d %18ld %18ld %18ld\n", s, sockets[s].from_same, sockets[s].from_other, sockets[s].handoffs);
+}
+
+const rw_policy_s rw_policy = {
+    .name = "cohort",
+    .gated = 1,
+    .read_lock = Read_lock,
+    .read_unlock = Read_unlock,
+    .write_lock = Write_lock,
+    .write_unlock = Write_unlock,
+    .report = Report,
+};
@@ -0,0 +1,157 @@
+/* Purpose:
+ *   Flat combining for the writers: instead of every insert/delete
+ *   taking the exclusive gate for one node, a writer publishes its
+ *   request in its own slot and one thread, the combiner, applies all
+ *   the pending requests under a single write lock.
+ *
+ *   Writer:  fills its slot (op, value) and marks it pending. If the
+ *            combiner lock is free it becomes the combiner: it takes
+ *            the write lock, collects every pending slot, sorts the
+ *            batch by value and applies it in one walk of the list
+ *            (list_impl.apply_batch), then hands each result back.
+ *            Otherwise it waits until its slot is served.
+ *   Reader:  a plain read lock on the same reader-writer lock.
+ *
+ * Notes:
+ *   1. One lock handoff and one list walk per batch instead of per
+ *      write; the more writers wait, the larger the batches.
+ *   2. Requests with the same value keep their slot order, which is a
+ *      valid order for requests that were all pending at once.
+ *   3. Lists without apply_batch get the batch one op at a time, still
+ *      under one write lock (Apply_batch in globals/helpers.c).
+ *   4. The read-write lock prefers writers, so the combiner is not
+ *      starved by a stream of readers.
+ */
+
+#define _GNU_SOURCE // pthread_rwlockattr_setkind_np
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "globals/helpers.h"
+
+#define CACHE_LINE 64
+#define SPIN_LIMIT 100
+
+/* One per thread, indexed by thread_rank */
+typedef struct{
+    _Atomic int pending;
+    write_req_s req;
+}__attribute__((aligned(CACHE_LINE))) fc_slot_s;
+
+static fc_slot_s slots[MAX_THREADS];
+static pthread_mutex_t combiner_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_rwlock_t list_lock;
+
+/* Only the combiner uses them */
+static write_req_s batch[MAX_THREADS];
+static int batch_slot[MAX_THREADS];
+
+/* ------------------ Local Helpers ------------------ */
+__attribute__((constructor)) static void Init_lock(void){
+    pthread_rwlockattr_t attr;
+
+    pthread_rwlockattr_init(&attr);
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+    pthread_rwlock_init(&list_lock, &attr);
+    pthread_rwlockattr_destroy(&attr);
+}
+
+__attribute__((destructor)) static void Destroy_lock(void){
+    pthread_rwlock_destroy(&list_lock);
+}
+
+/* Sorts batch[0..n) and batch_slot with it by value, keeping the slot
+ * order of equal values (insertion sort: batches are small) */
+static void Sort_batch(int n){
+    for (int i = 1; i < n; i++){
+        write_req_s req = batch[i];
+        int slot = batch_slot[i], j = i - 1;
+
+        while (j >= 0 && batch[j].value > req.value){
+            batch[j + 1] = batch[j];
+            batch_slot[j + 1] = batch_slot[j];
+            j--;
+        }
+        batch[j + 1] = req;
+        batch_slot[j + 1] = slot;
+    }
+}
+
+/* Combiner only (combiner_mtx held) */
+static void Combine(void){
+    int n = 0;
+
+    pthread_rwlock_wrlock(&list_lock);
+// 1. Collect the pending requests
+    for (int t = 0; t < thread_count; t++)
+        if (atomic_load_explicit(&slots[t].pending, memory_order_acquire)){
+            batch[n] = slots[t].req;
+            batch_slot[n++] = t;
+        }
+
+// 2. Apply them in one sorted walk
+    Sort_batch(n);
+    Apply_batch(batch, n);
+    pthread_rwlock_unlock(&list_lock);
+
+// 3. Hand the results back
+    for (int i = 0; i < n; i++){
+        fc_slot_s *slot = &slots[batch_slot[i]];
+        slot->req.result = batch[i].result;
+        atomic_store_explicit(&slot->pending, 0, memory_order_release);
+    }
+}
+
+/* ------------------ Reader Enters / Leaves ------------------ */
+static void Read_lock(void){
+    pthread_rwlock_rdlock(&list_lock);
+}
+
+static void Read_unlock(void){
+    pthread_rwlock_unlock(&list_lock);
+}
+
+/* ------------------ Writer Enters / Leaves ------------------
+ * Only for a single write outside of write_op
+ */
+static void Write_lock(void){
+    pthread_rwlock_wrlock(&list_lock);
+}
+
+static void Write_unlock(void){
+    pthread_rwlock_unlock(&list_lock);
+}
+
+/* ------------------ Combined Write ------------------ */
+static int Write_op(int op, int value){
+    fc_slot_s *mine = &slots[thread_rank];
+    int spins = 0;
+
+    mine->req.op = op;
+    mine->req.value = value;
+    atomic_store_explicit(&mine->pending, 1, memory_order_release);
+
+    while (atomic_load_explicit(&mine->pending, memory_order_acquire)){
+        if (pthread_mutex_trylock(&combiner_mtx) == 0){
+            if (atomic_load_explicit(&mine->pending, memory_order_acquire))
+                Combine();
+            pthread_mutex_unlock(&combiner_mtx);
+        }
+        else if (++spins > SPIN_LIMIT)
+            sched_yield();
+    }
+    return mine->req.result;
+}
+
+const rw_policy_s rw_policy = {
+    .name = "flat_combining",
+    .gated = 1,
+    .read_lock = Read_lock,
+    .read_unlock = Read_unlock,
+    .write_lock = Write_lock,
+    .write_unlock = Write_unlock,
+    .write_op = Write_op,
+};
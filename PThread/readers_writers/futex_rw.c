@@ -0,0 +1,119 @@
+/* Purpose:
+ *   The writer-priority protocol of priorityW.c without the condition
+ *   variables: the state is one atomic word and the waiters park on
+ *   Linux futexes, readers and writers on different words, so a release
+ *   wakes only the threads that can go on:
+ *     - a writer leaving hands over to ONE waiting writer, or else
+ *       wakes all the readers (they can all read together);
+ *     - the last reader leaving wakes ONE waiting writer.
+ *   priorityW.c instead broadcasts, and every woken thread then queues
+ *   on data_mtx just to find out that it has to sleep again.
+ *
+ * Notes:
+ *   1. state counts the active readers; WRITER is set while a writer is
+ *      in. writers_waiting makes new readers wait (writer priority).
+ *   2. Waiting is adaptive: spin SPIN_LIMIT times, then park. A waiter
+ *      reads the sequence word of its futex before checking the state
+ *      once more, and the waker changes the state before bumping the
+ *      sequence, so a wakeup between the check and the park is not lost
+ *      (FUTEX_WAIT returns at once if the word changed).
+ *   3. Linux only (futex(2)).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "globals/helpers.h"
+
+#define CACHE_LINE 64
+#define SPIN_LIMIT 100
+#define WRITER 0x80000000u
+
+static _Atomic unsigned state __attribute__((aligned(CACHE_LINE))) = 0;
+static _Atomic int writers_waiting = 0;
+static _Atomic unsigned read_seq __attribute__((aligned(CACHE_LINE))) = 0;  // readers park here
+static _Atomic unsigned write_seq __attribute__((aligned(CACHE_LINE))) = 0; // writers park here
+
+/* ------------------ Local Helpers ------------------ */
+static void Futex_wait(_Atomic unsigned *word, unsigned seen){
+    syscall(SYS_futex, (unsigned *)word, FUTEX_WAIT_PRIVATE, seen, NULL, NULL, 0);
+    gate_wakeups++;
+}
+
+static void Futex_wake(_Atomic unsigned *word, int waiters){
+    atomic_fetch_add(word, 1);
+    syscall(SYS_futex, (unsigned *)word, FUTEX_WAKE_PRIVATE, waiters, NULL, NULL, 0);
+}
+
+static inline int Reader_blocked(void){
+    return (atomic_load(&state) & WRITER) || atomic_load(&writers_waiting) > 0;
+}
+
+/* ------------------ Reader Enters / Leaves ------------------ */
+static void Read_lock(void){
+    int spins = 0;
+
+    for (;;){
+        unsigned s = atomic_load(&state);
+        if (!(s & WRITER) && atomic_load(&writers_waiting) == 0){
+            if (atomic_compare_exchange_weak(&state, &s, s + 1))
+                return;
+            continue;
+        }
+        if (++spins < SPIN_LIMIT)
+            continue;
+// Park until a writer leaves
+        unsigned seen = atomic_load(&read_seq);
+        if (Reader_blocked())
+            Futex_wait(&read_seq, seen);
+        spins = 0;
+    }
+}
+
+static void Read_unlock(void){
+// The last reader out lets one waiting writer in
+    if (atomic_fetch_sub(&state, 1) == 1 && atomic_load(&writers_waiting) > 0)
+        Futex_wake(&write_seq, 1);
+}
+
+/* ------------------ Writer Enters / Leaves ------------------ */
+static void Write_lock(void){
+    int spins = 0;
+
+    atomic_fetch_add(&writers_waiting, 1);
+    for (;;){
+        unsigned s = 0;
+        if (atomic_compare_exchange_weak(&state, &s, WRITER))
+            break;
+        if (++spins < SPIN_LIMIT)
+            continue;
+// Park until the readers or the writer in front leave
+        unsigned seen = atomic_load(&write_seq);
+        if (atomic_load(&state) != 0)
+            Futex_wait(&write_seq, seen);
+        spins = 0;
+    }
+    atomic_fetch_sub(&writers_waiting, 1);
+}
+
+static void Write_unlock(void){
+    atomic_store(&state, 0);
+    if (atomic_load(&writers_waiting) > 0)
+        Futex_wake(&write_seq, 1);       // writer priority: the next writer
+    else
+        Futex_wake(&read_seq, INT_MAX);  // all the readers
+}
+
+const rw_policy_s rw_policy = {
+    .name = "futex_rw",
+    .gated = 1,
+    .read_lock = Read_lock,
+    .read_unlock = Read_unlock,
+    .write_lock = Write_lock,
+    .write_unlock = Write_unlock,
+};
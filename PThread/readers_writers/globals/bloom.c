@@ -0,0 +1,109 @@
+/* Purpose:
+ *     A counting Bloom filter in front of the list, for the -F option:
+ *     most keys looked up in the benchmark are not in the list, and the
+ *     filter answers "not in the list" without the gate and the walk.
+ *
+ *     Bloom_init:   sizes the filter for the expected number of keys
+ *     Bloom_maybe:  0 if value is surely not in the list
+ *     Bloom_add / Bloom_remove:  one more / one less key in the list
+ *
+ * Notes:
+ *     1. BLOOM_HASHES counters per key, BLOOM_COUNTERS_PER_KEY counters
+ *        per expected key: about 1% of the misses still walk the list.
+ *     2. Counters instead of bits, so Delete can take a key out. They
+ *        are atomic and the readers never lock.
+ *     3. No false negatives, even with the lists that have no gate:
+ *        Insert counts a key BEFORE it links it (and takes it back if
+ *        it was already there), Delete uncounts it only AFTER it is
+ *        unlinked, so a counter is never less than the keys in the
+ *        list that map to it.
+ *     4. A counter that reaches UINT16_MAX sticks there: it no longer
+ *        knows how many keys it counts, so Delete never takes it back
+ *        down. With -F much smaller than the list this only costs walks;
+ *        a counter that wrapped to 0 would hide keys that are there.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "helpers.h"
+
+#define BLOOM_HASHES 7
+#define BLOOM_COUNTERS_PER_KEY 10
+
+static _Atomic uint16_t *counters = NULL;
+static uint64_t mask = 0;  // counters - 1, a power of two
+
+/* ------------------ Local Helpers ------------------ */
+/* Two independent hashes of value; counter i is h1 + i * h2 */
+static inline void Hashes(int value, uint64_t *h1, uint64_t *h2){
+    uint64_t z = (uint64_t)(uint32_t)value + 0x9E3779B97F4A7C15ULL;
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    *h1 = z & 0xFFFFFFFFu;
+    *h2 = (z >> 32) | 1;
+}
+
+/* Adds delta (+1 or -1) to the counter, unless it is saturated */
+static inline void Bump(_Atomic uint16_t *counter, int delta){
+    uint16_t c = atomic_load_explicit(counter, memory_order_relaxed);
+
+    while (c != UINT16_MAX &&
+           !atomic_compare_exchange_weak_explicit(counter, &c, (uint16_t)(c + delta),
+                                                  memory_order_release, memory_order_relaxed))
+        ;
+}
+
+/*------------------- Create / Destroy ------------------- */
+int Bloom_init(long expected_keys){
+    uint64_t size = 64;
+
+    while (size < (uint64_t)expected_keys * BLOOM_COUNTERS_PER_KEY)
+        size <<= 1;
+    counters = calloc(size, sizeof(*counters));
+    if (counters == NULL)
+        return 0;
+    mask = size - 1;
+    return 1;
+}
+
+void Bloom_clear(void){
+    for (uint64_t i = 0; counters != NULL && i <= mask; i++)
+        atomic_store_explicit(&counters[i], 0, memory_order_relaxed);
+}
+
+void Bloom_destroy(void){
+    free(counters);
+    counters = NULL;
+}
+
+/*------------------- Lookup / Update ------------------- */
+int Bloom_maybe(int value){
+    uint64_t h1, h2;
+
+    Hashes(value, &h1, &h2);
+    for (int i = 0; i < BLOOM_HASHES; i++)
+        if (atomic_load_explicit(&counters[(h1 + i * h2) & mask], memory_order_acquire) == 0)
+            return 0;
+    return 1;
+}
+
+void Bloom_add(int value){
+    uint64_t h1, h2;
+
+    Hashes(value, &h1, &h2);
+    for (int i = 0; i < BLOOM_HASHES; i++)
+        Bump(&counters[(h1 + i * h2) & mask], 1);
+}
+
+void Bloom_remove(int value){
+    uint64_t h1, h2;
+
+    Hashes(value, &h1, &h2);
+    for (int i = 0; i < BLOOM_HASHES; i++)
+        Bump(&counters[(h1 + i * h2) & mask], -1);
+}
@@ -0,0 +1,158 @@
+/* Purpose:
+ *     Fills the empty list with the initial keys in O(m log m) instead
+ *     of m calls to Insert that walk the list (O(m^2)).
+ *
+ *     Bulk_fill:  draws the same keys as the Insert loop did, sorts them
+ *                 in parallel, drops the duplicates and links them
+ *
+ * Notes:
+ *     1. The keys: my_rand with seed 1, until m distinct ones or 2m
+ *        draws. They are drawn in rounds of (m - distinct so far), which
+ *        gives exactly the set the one-by-one Insert loop gave.
+ *     2. The sort: `threads` threads qsort one chunk each, then pairs of
+ *        sorted runs are merged, also in parallel, until one is left.
+ *     3. The link: list_impl.bulk_load builds the list in one pass
+ *        (globals/list.c, globals/unrolled_list.c,
+ *        globals/sharded_list.c); the other lists get
+ *        the keys through Insert from the largest down, so every insert
+ *        lands at the front and costs O(1) (O(log m) in the skip list).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "../../../helpers/my_rand.h"
+
+#include "helpers.h"
+
+#define BULK_MIN_CHUNK 65536  // fewer keys per thread: not worth a thread
+
+typedef struct{
+    int *keys;
+    int *tmp;
+    long lo, mid, hi;  // sort [lo, hi), or merge [lo, mid) with [mid, hi)
+}sort_job_s;
+
+/* ------------------ Local Helpers ------------------ */
+static int Compare_ints(const void *a, const void *b){
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static void *Sort_chunk(void *arg){
+    sort_job_s *job = arg;
+
+    qsort(job->keys + job->lo, job->hi - job->lo, sizeof(int), Compare_ints);
+    return NULL;
+}
+
+static void *Merge_runs(void *arg){
+    sort_job_s *job = arg;
+    long i = job->lo, j = job->mid, k = job->lo;
+
+    while (i < job->mid && j < job->hi)
+        job->tmp[k++] = job->keys[i] <= job->keys[j] ? job->keys[i++] : job->keys[j++];
+    while (i < job->mid)
+        job->tmp[k++] = job->keys[i++];
+    while (j < job->hi)
+        job->tmp[k++] = job->keys[j++];
+    return NULL;
+}
+
+/* Runs one job per thread (the last one in the calling thread) */
+static void Run_jobs(void *(*task)(void *), sort_job_s *jobs, int count){
+    pthread_t handles[MAX_THREADS];
+
+    for (int t = 0; t < count - 1; t++)
+        pthread_create(&handles[t], NULL, task, &jobs[t]);
+    task(&jobs[count - 1]);
+    for (int t = 0; t < count - 1; t++)
+        pthread_join(handles[t], NULL);
+}
+
+/* Sorts keys[0, n) with up to `threads` threads */
+static void Parallel_sort(int *keys, long n, int threads){
+    sort_job_s jobs[MAX_THREADS];
+    long bounds[MAX_THREADS + 1];
+    int *buf, *src = keys, *dst, *swap;
+
+    if (threads > n / BULK_MIN_CHUNK)
+        threads = (int)(n / BULK_MIN_CHUNK);
+    if (threads < 2 || (buf = malloc(n * sizeof(int))) == NULL){
+        qsort(keys, n, sizeof(int), Compare_ints);
+        return;
+    }
+    dst = buf;
+
+// 1. Every thread sorts its chunk
+    for (int t = 0; t <= threads; t++)
+        bounds[t] = n * t / threads;
+    for (int t = 0; t < threads; t++)
+        jobs[t] = (sort_job_s){keys, NULL, bounds[t], 0, bounds[t + 1]};
+    Run_jobs(Sort_chunk, jobs, threads);
+
+// 2. Merge the runs two by two from src to dst, a round at a time
+    for (int runs = threads; runs > 1; runs = (runs + 1) / 2){
+        int pairs = runs / 2;
+
+        for (int p = 0; p < pairs; p++)
+            jobs[p] = (sort_job_s){src, dst, bounds[2 * p], bounds[2 * p + 1], bounds[2 * p + 2]};
+        Run_jobs(Merge_runs, jobs, pairs);
+        if (runs % 2) // the odd run out is copied as it is
+            memcpy(dst + bounds[runs - 1], src + bounds[runs - 1], (n - bounds[runs - 1]) * sizeof(int));
+        for (int p = 0; p <= (runs + 1) / 2; p++)
+            bounds[p] = bounds[2 * p < runs ? 2 * p : runs];
+        swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != keys)
+        memcpy(keys, src, n * sizeof(int));
+    free(buf);
+}
+
+/* Keeps one of each key of the sorted keys[0, n) */
+static long Dedup(int *keys, long n){
+    long u = 0;
+
+    for (long i = 0; i < n; i++)
+        if (u == 0 || keys[i] != keys[u - 1])
+            keys[u++] = keys[i];
+    return u;
+}
+
+/*------------------- Fill the List ------------------- */
+/* Returns the number of keys in the list */
+long Bulk_fill(int inserts_in_main, int threads){
+    int *keys;
+    long distinct = 0, drawn = 0, attempts = 2L * inserts_in_main;
+    unsigned seed = 1;
+
+    if (inserts_in_main <= 0)
+        return 0;
+    if ((keys = malloc(attempts * sizeof(int))) == NULL){
+        perror("Bulk_fill");
+        exit(EXIT_FAILURE);
+    }
+    while (distinct < inserts_in_main && drawn < attempts){
+        long round = inserts_in_main - distinct;
+
+        for (long i = 0; i < round && drawn < attempts; i++, drawn++)
+            keys[distinct++] = my_rand(&seed) % MAX_KEY;
+        Parallel_sort(keys, distinct, threads);
+        distinct = Dedup(keys, distinct);
+    }
+
+    if (list_impl.bulk_load != NULL){
+        for (long i = 0; use_bloom && i < distinct; i++)
+            Bloom_add(keys[i]);
+        list_impl.bulk_load(keys, (int)distinct);
+    }
+    else
+        for (long i = distinct - 1; i >= 0; i--)
+            Insert(keys[i]);
+    free(keys);
+
+    return distinct;
+}
@@ -0,0 +1,174 @@
+/* Purpose:
+ *     Epoch-based reclamation for the lists that are read without a
+ *     lock. A node unlinked by one thread may still be read by another
+ *     thread that reached it before the unlink, so it cannot be freed
+ *     right away: it is "retired" and freed once every thread has
+ *     finished the operations that could have seen it.
+ *
+ *     Epoch_enter / Epoch_exit:  around every list operation
+ *     Epoch_retire:              hands over an unlinked node
+ *     Epoch_drain:               frees everything (no threads running)
+ *
+ * Notes:
+ *     1. There is a global epoch. A thread inside an operation
+ *        announces the epoch it started in, in its own cache line
+ *        (indexed by thread_rank).
+ *     2. A retired node is tagged with the global epoch read after the
+ *        unlink. The global epoch only moves from e to e+1 when every
+ *        active thread has announced e, so once it reaches tag+2 no
+ *        operation that started before the unlink is still running.
+ *     3. Each thread keeps its own list of retired nodes, no locking.
+ *     4. Entering an operation needs a full fence between announcing
+ *        the epoch and reading the first node. On Linux the fence is
+ *        moved to the (rare) thread that advances the epoch with
+ *        membarrier(): it forces a barrier on every running thread, so
+ *        readers only need a compiler barrier and write nothing but
+ *        their own slot. -DNO_MEMBARRIER keeps the fence in readers.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#if defined(__linux__) && !defined(NO_MEMBARRIER)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/membarrier.h>
+#endif
+
+#include "helpers.h"
+
+#define CACHE_LINE 64
+// Try to advance the epoch and free nodes every EPOCH_FREQ retires
+#define EPOCH_FREQ 64
+
+typedef struct{
+    void *ptr;
+    void (*reclaim)(void *ptr);
+    unsigned long epoch;
+}retired_s;
+
+/* One per thread, a cache line each so announcing does not bounce */
+typedef struct{
+    _Atomic unsigned long state;  // (epoch << 1) | 1 while inside an operation
+    int depth;                    // nested Epoch_enter calls
+    int count, capacity;
+    retired_s *retired;
+}__attribute__((aligned(CACHE_LINE))) epoch_slot_s;
+
+static _Atomic unsigned long global_epoch = 0;
+static epoch_slot_s slots[MAX_THREADS];
+static int use_membarrier = 0;
+
+/* ------------------ Local Helpers ------------------ */
+static epoch_slot_s *My_slot(void){
+    return &slots[thread_rank];
+}
+
+/* Registers the process for membarrier(), when the kernel has it */
+__attribute__((constructor)) static void Init_membarrier(void){
+#if defined(__linux__) && !defined(NO_MEMBARRIER) && defined(__NR_membarrier)
+    long cmds = syscall(__NR_membarrier, MEMBARRIER_CMD_QUERY, 0, 0);
+
+    if (cmds > 0 && (cmds & MEMBARRIER_CMD_PRIVATE_EXPEDITED) &&
+        syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0)
+        use_membarrier = 1;
+#endif
+}
+
+/* The fence of the thread that reads the slots of the others */
+static void Heavy_fence(void){
+#if defined(__linux__) && !defined(NO_MEMBARRIER) && defined(__NR_membarrier)
+    if (use_membarrier){
+        syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+        return;
+    }
+#endif
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+/* Advance the epoch if every active thread has caught up with it */
+static void Try_advance(void){
+    unsigned long epoch = atomic_load(&global_epoch);
+    int threads = thread_count > 0 ? thread_count : 1;
+
+    Heavy_fence();
+    for (int i = 0; i < threads; i++){
+        unsigned long state = atomic_load_explicit(&slots[i].state, memory_order_acquire);
+        if ((state & 1) && (state >> 1) != epoch)
+            return;
+    }
+    atomic_compare_exchange_strong(&global_epoch, &epoch, epoch + 1);
+}
+
+/* Free the retired nodes that are two epochs old */
+static void Reclaim(epoch_slot_s *slot){
+    unsigned long epoch = atomic_load(&global_epoch);
+    int kept = 0;
+
+    for (int i = 0; i < slot->count; i++){
+        if (slot->retired[i].epoch + 2 <= epoch)
+            slot->retired[i].reclaim(slot->retired[i].ptr);
+        else
+            slot->retired[kept++] = slot->retired[i];
+    }
+    slot->count = kept;
+}
+
+/*------------------- Enter an Operation ------------------- */
+void Epoch_enter(void){
+    epoch_slot_s *slot = My_slot();
+
+    if (slot->depth++ > 0)
+        return;
+    atomic_store_explicit(&slot->state, (atomic_load(&global_epoch) << 1) | 1, memory_order_relaxed);
+// The announcement must be visible before the first node is read
+    if (use_membarrier)
+        atomic_signal_fence(memory_order_seq_cst);  // Heavy_fence does the rest
+    else
+        atomic_thread_fence(memory_order_seq_cst);
+}
+
+/*------------------- Leave an Operation ------------------- */
+void Epoch_exit(void){
+    epoch_slot_s *slot = My_slot();
+
+    if (--slot->depth > 0)
+        return;
+    atomic_store_explicit(&slot->state, 0, memory_order_release);
+}
+
+/*------------------- Retire an Unlinked Node ------------------- */
+void Epoch_retire(void *ptr, void (*reclaim)(void *ptr)){
+    epoch_slot_s *slot = My_slot();
+
+    if (slot->count == slot->capacity){
+        slot->capacity = slot->capacity ? 2 * slot->capacity : 2 * EPOCH_FREQ;
+        slot->retired = realloc(slot->retired, slot->capacity * sizeof(retired_s));
+        if (slot->retired == NULL){
+            perror("Epoch_retire");
+            exit(EXIT_FAILURE);
+        }
+    }
+    slot->retired[slot->count].ptr = ptr;
+    slot->retired[slot->count].reclaim = reclaim;
+    slot->retired[slot->count].epoch = atomic_load(&global_epoch);
+    slot->count++;
+
+    if (slot->count % EPOCH_FREQ == 0){
+        Try_advance();
+        Reclaim(slot);
+    }
+}
+
+/*------------------- Free Everything ------------------- */
+/* Only when no other thread is inside an operation */
+void Epoch_drain(void){
+    for (int i = 0; i < MAX_THREADS; i++){
+        for (int j = 0; j < slots[i].count; j++)
+            slots[i].retired[j].reclaim(slots[i].retired[j].ptr);
+        free(slots[i].retired);
+        slots[i].retired = NULL;
+        slots[i].count = slots[i].capacity = 0;
+    }
+}
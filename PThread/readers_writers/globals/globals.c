@@ -18,6 +18,12 @@ int thread_count = 0;
 int total_ops = 0;
 double insert_percent = 0.0;
 double search_percent = 0.0;
+__thread long thread_rank = 0; // set by Thread_task, indexes the per-thread slots
+int record_latency = 0;
+int shard_count = 16; // -s, for globals/sharded_list.c
+int use_bloom = 0;
+__thread long gate_wakeups = 0;
+histogram_s op_hist[OP_TYPES][HIST_KINDS];
 
 // 2. Define and Initialize Shared Synchronization Resources
 pthread_mutex_t count_mutex; // Will be initialized by function call in main.c
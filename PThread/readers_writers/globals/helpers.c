@@ -1,6 +1,6 @@
 /* Purpose:
  *     Functions that help with the reading and writing(insert-delete)
- *      operations of the linked list. Also functions for the shared 
+ *      operations of the linked list. Also functions for the shared
  *      structure that the threads have to lock/unlock and count the
  *      queue.
  */
@@ -14,13 +14,23 @@
 #include "helpers.h"
 
 
-list_node_s *head = NULL;
-
 /* -------------------- Usage / Help -------------------- */
 void usage(char *prog_name){
-    fprintf(stderr, "usage: %s <thread_count>\n", prog_name);
+    fprintf(stderr, "usage: %s <m> <total_ops> <search_percent> <insert_percent> <thread_count> [options]\n", prog_name);
+    fprintf(stderr, "  -H         per-operation latency and lock-wait histograms\n");
+    fprintf(stderr, "  -D dist    keys: uniform (default), zipf[:theta], hotspot[:fraction[:probability]]\n");
+    fprintf(stderr, "  -M p:k,..  phases with their own read/insert percentages (instead of the arguments)\n");
+    fprintf(stderr, "  -w file    record the generated operations as a trace\n");
+    fprintf(stderr, "  -r file    replay a trace (its threads and ops replace the arguments)\n");
+    fprintf(stderr, "  -s shards  key-range shards of globals/sharded_list.c (default 16)\n");
+    fprintf(stderr, "  -d secs    run for a fixed time (cycling through the ops) and report ops/sec\n");
+    fprintf(stderr, "  -b n       consecutive lookups in batches of up to n (at most %d), one gate and walk each\n", MAX_BATCH);
+    fprintf(stderr, "  -F keys    Bloom filter sized for `keys` keys: most misses skip the gate and the walk\n");
+    fprintf(stderr, "  -P         contention profile: gate wait / hold time, handoffs, futile wakeups\n");
+    fprintf(stderr, "  -R f[:w]   a fraction f of the lookups become range scans of w keys (100 by default)\n");
+    fprintf(stderr, "  -S         scaling curve: 1, 2, 4, ... thread_count threads, -d secs each (default 1)\n");
     exit(0);
-} 
+}
  /*-----------------------------------------------------------------*/
 // void get_input(){
 //     printf("How many keys should be inserted in the main thread?\n");
@@ -32,7 +42,7 @@ void usage(char *prog_name){
 //     printf("Percent of ops that should be inserts? (between 0 and 1)\n");
 //     scanf("%lf", &insert_percent);
 //     delete_percent = 1.0 - (search_percent + insert_percent);
-// } 
+// }
 
 /* ----------- Initialize Shared Structure ------------- */
 int init_read_write_threads(read_write_data *rw_struct){
@@ -58,7 +68,7 @@ int init_read_write_threads(read_write_data *rw_struct){
     rw_struct->reading = 0;
     rw_struct->wait_wrt = 0;
     rw_struct->writing = 0;
-    
+
     return result;
 }
 
@@ -70,135 +80,112 @@ void destroy_read_write_threads(read_write_data *rw_struct){
 }
 
 /*---------------------- List Oeprations ---------------------- */
+/* The operations go to the list implementation linked in (LIST_SRC).
+ * With -F they also keep the Bloom filter (bloom.c) in step: a key is
+ * counted before it is linked and uncounted after it is unlinked. */
 
-/*------------------- Insert Node Operation ------------------- */
-/* Insert value in correct numerical location into list */
-/* If value is not in list, return 1, else return 0 */
 int Insert(int value){
-    list_node_s *curr = head;
-    list_node_s *pred = NULL;
-    list_node_s *temp;
-    int rv = 1;
-
-    while (curr != NULL && curr->data < value){
-        pred = curr;
-        curr = curr->next;
-    }
-
-    if (curr == NULL || curr->data > value){
-        temp = malloc(sizeof(list_node_s));
-        temp->data = value;
-        temp->next = curr;
-        if (pred == NULL)
-            head = temp;
-        else
-            pred->next = temp;
-    }
-    else{ /* value in list */
-        not_insert++;
-        rv = 0;
-    }
+    int rv;
 
+    if (use_bloom)
+        Bloom_add(value);
+    rv = list_impl.insert(value);
+    if (use_bloom && !rv) // it was there already
+        Bloom_remove(value);
     return rv;
-} 
-/*------------------ Print Operation ------------------*/
-void Print(void){
-    list_node_s *temp;
-    int i = 0;
-
-    temp = head;
-
-    while (temp != (list_node_s *)NULL){
-        i++;
-        temp = temp->next;
-    }
-    printf("num of nodes %d\n", i); // to make sure that all the operations are correctlty done
-    printf("The numbers of insertion is %d and of deletes %d\n", insert_count - not_insert, delete_count - not_deleted);
-} 
+}
 
-/*-----------------------------------------------------------------*/
 int Member(int value){
-    list_node_s *temp;
-    temp = head;
+    return list_impl.member(value);
+}
 
-    while (temp != NULL && temp->data < value)
-        temp = temp->next;
+/* Looks up n keys in any order: sorts them and answers them all in one
+ * walk of the list (list_impl.member_batch), or one by one if the list
+ * has no batch walk. found[i] is 1 if keys[i] is in the list. The
+ * caller holds the gate, once for the whole batch. */
+typedef struct{
+    int key;
+    int index;
+}batch_key_s;
+
+static int Compare_keys(const void *a, const void *b){
+    int x = ((const batch_key_s *)a)->key, y = ((const batch_key_s *)b)->key;
+    return (x > y) - (x < y);
+}
 
-    if (temp == NULL || temp->data > value){
-#ifdef DEBUG
-        printf("%d is not in the list\n", value);
-#endif
-        return 0;
-    }
-    else{
-#ifdef DEBUG
-        printf("%d is in the list\n", value);
-#endif
-        return 1;
-    }
-} 
-/*--------------------- Delete Node Operation --------------------- */
-/* Deletes value from list */
-/* If value is in list, return 1, else return 0 */
-int Delete(int value){
-    list_node_s *curr = head;
-    list_node_s *pred = NULL;
-    int rv = 1;
+void Member_batch(const int *keys, int *found, int n){
+    batch_key_s sorted[MAX_BATCH];
+    int sorted_keys[MAX_BATCH], sorted_found[MAX_BATCH];
 
-    while (curr != NULL && curr->data < value){
-        pred = curr;
-        curr = curr->next;
+    if (list_impl.member_batch == NULL){
+        for (int i = 0; i < n; i++)
+            found[i] = Member(keys[i]);
+        return;
     }
+    for (int start = 0; start < n; start += MAX_BATCH){
+        int count = n - start < MAX_BATCH ? n - start : MAX_BATCH;
 
-    if (curr != NULL && curr->data == value){
-        if (pred == NULL){ /* first element in list */
-            head = curr->next;
-#ifdef DEBUG
-            printf("Freeing %d\n", value);
-#endif
-            free(curr);
+        for (int i = 0; i < count; i++){
+            sorted[i].key = keys[start + i];
+            sorted[i].index = start + i;
         }
-        else{
-            pred->next = curr->next;
-#ifdef DEBUG
-            printf("Freeing %d\n", value);
-#endif
-            free(curr);
-        }
-    }
-    else{ /* Not in list */
-        not_deleted++;
-        rv = 0;
+        qsort(sorted, count, sizeof(batch_key_s), Compare_keys);
+        for (int i = 0; i < count; i++)
+            sorted_keys[i] = sorted[i].key;
+        list_impl.member_batch(sorted_keys, sorted_found, count);
+        for (int i = 0; i < count; i++)
+            found[sorted[i].index] = sorted_found[i];
     }
+}
+
+int Delete(int value){
+    int rv = list_impl.delete(value);
 
+    if (use_bloom && rv)
+        Bloom_remove(value);
     return rv;
-} /* Delete */
-/*------------------ Free-List Operation --------------------*/
-void Free_list(void){
-    list_node_s *current;
-    list_node_s *following;
+}
 
-    if (Is_empty())
+/* Inserts / deletes sorted by value, in one walk (list_impl.apply_batch)
+ * or one by one. The caller holds the gate. */
+void Apply_batch(write_req_s *reqs, int n){
+    if (list_impl.apply_batch == NULL){
+        for (int i = 0; i < n; i++)
+            reqs[i].result = reqs[i].op == OP_INSERT ? Insert(reqs[i].value) : Delete(reqs[i].value);
         return;
-    current = head;
-    following = current->next;
-    while (following != NULL){
-#ifdef DEBUG
-        printf("Freeing %d\n", current->data);
-#endif
-        free(current);
-        current = following;
-        following = current->next;
     }
-#ifdef DEBUG
-    printf("Freeing %d\n", current->data);
-#endif
-    free(current);
-} 
-/*------------------- Check If List Is Empty ------------------- */
+    for (int i = 0; use_bloom && i < n; i++)
+        if (reqs[i].op == OP_INSERT)
+            Bloom_add(reqs[i].value);
+    list_impl.apply_batch(reqs, n);
+    for (int i = 0; use_bloom && i < n; i++)
+        if ((reqs[i].op == OP_INSERT) != reqs[i].result) // failed insert or done delete
+            Bloom_remove(reqs[i].value);
+}
+
+/* The keys of the list in [lo, hi] in increasing order, all as of one
+ * moment: returns how many there are and stores the first max of them
+ * in keys (Range(INT_MIN, INT_MAX, ...) walks the whole list). The
+ * caller holds the read gate; globals/rcu_list.c reads a snapshot with
+ * no gate. -1 if the list has no range scans. */
+int Range(int lo, int hi, int *keys, int max){
+    if (list_impl.range == NULL)
+        return -1;
+    return list_impl.range(lo, hi, keys, max);
+}
+
+void Free_list(void){
+    list_impl.free_list();
+    if (use_bloom)
+        Bloom_clear();
+}
+
 int Is_empty(void){
-    if (head == NULL)
-        return 1;
-    else
-        return 0;
-} 
+    return list_impl.size() == 0;
+}
+
+/*------------------ Print Operation ------------------*/
+void Print(void){
+    printf("num of nodes %d\n", list_impl.size()); // to make sure that all the operations are correctlty done
+    printf("The numbers of insertion is %d and of deletes %d\n", insert_count - not_insert, delete_count - not_deleted);
+}
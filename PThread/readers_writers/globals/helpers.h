@@ -1,4 +1,4 @@
-/* The header file with the declarations of the variables, 
+/* The header file with the declarations of the variables,
  * data structures and function names that all the source files use.
  */
 
@@ -6,13 +6,24 @@
 #ifndef _HELPERS_H
 #define _HELPERS_H
 
-/* Random ints are less than MAX_KEY */
-#define MAX_KEY 100000000;
+#include <stddef.h>
+#include <pthread.h>
+
+/* Random ints are less than MAX_KEY (-DMAX_KEY=... for a denser list) */
+#ifndef MAX_KEY
+#define MAX_KEY 100000000
+#endif
+
+/* Per-thread slots (epochs, ...) are indexed by thread_rank */
+#define MAX_THREADS 256
+
+/* Keys sorted at once by Member_batch (-b) */
+#define MAX_BATCH 256
 
 /* ---------------- Extern Variables Declaration ---------------- */
 extern int member_count;
 extern int delete_count;
-extern int not_deleted; 
+extern int not_deleted;
 extern int not_insert;
 extern int insert_count;
 extern int thread_count;
@@ -21,6 +32,11 @@ extern double insert_percent;
 extern double search_percent;
 extern double delete_percent;
 extern pthread_mutex_t count_mutex;
+extern __thread long thread_rank; // 0 in the main thread
+extern int record_latency;        // -H: per-operation histograms
+extern int shard_count;           // -s: shards of globals/sharded_list.c
+extern int use_bloom;             // -F: Bloom filter in front of the list
+extern __thread long gate_wakeups; // returns from a blocking wait of the policy (-P)
 
 
 // ---------- Structure for Threads -------------
@@ -34,7 +50,24 @@ typedef struct{
     int writing;
 }read_write_data;
 
-extern read_write_data shared_resources;   
+extern read_write_data shared_resources;
+
+/* ---------------- Reader-Writer Policy ----------------
+ * Every P_SRC file (priorityR.c, priorityW.c, ...) defines rw_policy:
+ * how a thread enters and leaves the list as a reader or a writer.
+ */
+typedef struct{
+    const char *name;
+    int gated;  // 0: no gate at all, the list has to be thread-safe
+    void (*read_lock)(void);
+    void (*read_unlock)(void);
+    void (*write_lock)(void);
+    void (*write_unlock)(void);
+    int (*write_op)(int op, int value); // optional: the policy runs the whole write
+    void (*report)(void);               // optional: its own statistics, at exit
+}rw_policy_s;
+
+extern const rw_policy_s rw_policy;
 
 /* ---------------- Helper Functions For Threads --------------- */
 void usage(char *prog_name);
@@ -50,14 +83,138 @@ typedef struct node_tag{
     struct node_tag *next;
 }list_node_s;
 
-extern list_node_s *head;
+/* A pending write, as handed to a policy's write_op or applied in a
+ * batch (apply_batch): op is OP_INSERT or OP_DELETE, result what
+ * Insert / Delete returned. */
+enum { OP_MEMBER, OP_INSERT, OP_DELETE, OP_RANGE, OP_TYPES };
+
+typedef struct{
+    int op;
+    int value;
+    int result;
+}write_req_s;
+
+/* ---------------- List Implementation ----------------
+ * Every LIST_SRC file (globals/list.c, globals/lf_list.c, ...) defines
+ * list_impl. A concurrent list can be used without a gate.
+ */
+typedef struct{
+    const char *name;
+    int concurrent;
+    void (*init)(void); // optional: once, after the options, before any operation
+    int (*insert)(int value);
+    int (*member)(int value);
+    int (*delete)(int value);
+    int (*size)(void);
+    void (*free_list)(void);
+    void (*apply_batch)(write_req_s *reqs, int n); // optional: reqs sorted by value, one walk
+    void (*member_batch)(const int *keys, int *found, int n); // optional: keys sorted, one walk
+    void (*bulk_load)(const int *keys, int n); // optional: empty list, keys sorted and distinct
+    int (*range)(int lo, int hi, int *keys, int max); // optional: see Range
+}list_impl_s;
+
+extern const list_impl_s list_impl;
 
 /*----------------- List operations ----------------- */
 int Insert(int value);
 void Print(void);
 int Member(int value);
+void Member_batch(const int *keys, int *found, int n);
+void Apply_batch(write_req_s *reqs, int n);
+int Range(int lo, int hi, int *keys, int max);
 int Delete(int value);
 void Free_list(void);
 int Is_empty(void);
 
+/* ------------------ Sharded Set (sharded_list.c) ------------------
+ * An independent set split by key range in shards, one lock each.
+ */
+typedef struct sharded_set_tag sharded_set_s;
+
+sharded_set_s *Set_create(int shards, int max_key);
+void Set_destroy(sharded_set_s *s);
+int Set_insert(sharded_set_s *s, int value);
+int Set_member(sharded_set_s *s, int value);
+int Set_delete(sharded_set_s *s, int value);
+int Set_size(sharded_set_s *s);
+
+/* ------------------ Node Allocation (node_pool.c) ------------------
+ * The lists allocate their nodes with NODE_ALLOC / NODE_FREE: malloc
+ * and free, or the per-thread pool with -DNODE_POOL (make ... POOL=1).
+ */
+void *Pool_alloc(size_t size);
+void Pool_free(void *ptr, size_t size);
+void Node_pool_destroy(void);
+
+#ifdef NODE_POOL
+#define NODE_ALLOC(size) Pool_alloc(size)
+#define NODE_FREE(ptr, size) Pool_free(ptr, size)
+#else
+#define NODE_ALLOC(size) malloc(size)
+#define NODE_FREE(ptr, size) free(ptr)
+#endif
+
+/* ------------------ Workload (workload.c) ------------------
+ * The ops of every thread, generated before the timer starts or
+ * replayed from a trace: workload[thread][0..ops_per_thread).
+ */
+typedef struct{
+    int op;   // OP_MEMBER, OP_INSERT, OP_DELETE or OP_RANGE
+    int key;  // OP_RANGE: the keys [key, key + range_width)
+}workload_op_s;
+
+extern workload_op_s **workload;
+extern int ops_per_thread;
+extern int range_width;
+
+int Workload_keys(const char *spec);
+int Workload_mix(const char *spec);
+int Workload_ranges(const char *spec);
+int Workload_has_ranges(void);
+void Workload_generate(void);
+int Workload_save(const char *path);
+int Workload_load(const char *path);
+void Workload_describe(void);
+void Workload_free(void);
+
+/* ------------------ Latency Histograms (histogram.c) ------------------
+ * Log-linear buckets: HIST_SUB per power of two, values in ns.
+ */
+#define HIST_SUB_BITS 4
+#define HIST_SUB (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS ((64 - HIST_SUB_BITS + 1) * HIST_SUB)
+
+enum { HIST_LATENCY, HIST_LOCK_WAIT, HIST_KINDS };
+
+typedef struct{
+    unsigned long counts[HIST_BUCKETS];
+    unsigned long count;
+    unsigned long max;
+}histogram_s;
+
+extern histogram_s op_hist[OP_TYPES][HIST_KINDS]; // merged at the join
+
+unsigned long Hist_now(void);
+void Hist_record(histogram_s *h, unsigned long value);
+void Hist_merge(histogram_s *into, const histogram_s *from);
+unsigned long Hist_percentile(const histogram_s *h, double p);
+void Hist_print(const char *label, const histogram_s *h);
+
+/* ------------------ Bulk Load (bulk_load.c) ------------------ */
+long Bulk_fill(int inserts_in_main, int threads);
+
+/* ------------------ Bloom Filter (bloom.c) ------------------ */
+int Bloom_init(long expected_keys);
+void Bloom_clear(void);
+void Bloom_destroy(void);
+int Bloom_maybe(int value);
+void Bloom_add(int value);
+void Bloom_remove(int value);
+
+/* ------------- Epoch-Based Reclamation (epoch.c) -------------- */
+void Epoch_enter(void);
+void Epoch_exit(void);
+void Epoch_retire(void *ptr, void (*reclaim)(void *ptr));
+void Epoch_drain(void);
+
 #endif
@@ -0,0 +1,91 @@
+/* Purpose:
+ *     Latency histograms in the style of HdrHistogram, for the -H option:
+ *     every thread records into its own histograms (no sharing, no
+ *     locks), main merges them after the join and prints percentiles.
+ *
+ *     Hist_now:        a monotonic timestamp in nanoseconds
+ *     Hist_record:     counts one value (ns)
+ *     Hist_merge:      adds one histogram to another
+ *     Hist_percentile: the value below which a fraction p of the counts lie
+ *     Hist_print:      count, p50, p99, p99.9 and max on one line
+ *
+ * Notes:
+ *     1. Log-linear buckets: values below HIST_SUB are exact, above that
+ *        every power of two is split in HIST_SUB equal buckets, so any
+ *        value is reported within 1/HIST_SUB (6%) of the real one.
+ *     2. A percentile reports the upper end of its bucket, never less
+ *        than the real value; max is exact.
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "helpers.h"
+
+/* ------------------ Local Helpers ------------------ */
+static int Bucket(unsigned long value){
+    int msb;
+
+    if (value < HIST_SUB)
+        return (int)value;
+    msb = 63 - __builtin_clzl(value);
+    return (msb - HIST_SUB_BITS + 1) * HIST_SUB + (int)((value >> (msb - HIST_SUB_BITS)) & (HIST_SUB - 1));
+}
+
+/* The largest value that falls in bucket b */
+static unsigned long Bucket_top(int b){
+    int group = b / HIST_SUB, sub = b % HIST_SUB;
+
+    if (group == 0)
+        return (unsigned long)b;
+    return (((unsigned long)(HIST_SUB + sub + 1)) << (group - 1)) - 1;
+}
+
+/*------------------- Timestamp ------------------- */
+unsigned long Hist_now(void){
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (unsigned long)t.tv_sec * 1000000000UL + t.tv_nsec;
+}
+
+/*------------------- Record / Merge ------------------- */
+void Hist_record(histogram_s *h, unsigned long value){
+    h->counts[Bucket(value)]++;
+    h->count++;
+    if (value > h->max)
+        h->max = value;
+}
+
+void Hist_merge(histogram_s *into, const histogram_s *from){
+    for (int b = 0; b < HIST_BUCKETS; b++)
+        into->counts[b] += from->counts[b];
+    into->count += from->count;
+    if (from->max > into->max)
+        into->max = from->max;
+}
+
+/*------------------- Percentiles ------------------- */
+unsigned long Hist_percentile(const histogram_s *h, double p){
+    unsigned long rank = (unsigned long)(p * h->count + 0.5), seen = 0;
+
+    if (h->count == 0)
+        return 0;
+    if (rank == 0)
+        rank = 1;
+    for (int b = 0; b < HIST_BUCKETS; b++){
+        seen += h->counts[b];
+        if (seen >= rank)
+            return Bucket_top(b) < h->max ? Bucket_top(b) : h->max;
+    }
+    return h->max;
+}
+
+void Hist_print(const char *label, const histogram_s *h){
+    if (h->count == 0){
+        printf("%-18s %10d ops\n", label, 0);
+        return;
+    }
+    printf("%-18s %10lu ops  p50 %9lu  p99 %9lu  p99.9 %9lu  max %9lu ns\n", label, h->count,
+           Hist_percentile(h, 0.50), Hist_percentile(h, 0.99), Hist_percentile(h, 0.999), h->max);
+}
@@ -0,0 +1,194 @@
+/* Purpose:
+ *     A sorted linked list of ints with one lock per node, so that
+ *     writers on disjoint parts of the list do not block each other
+ *     and no gate is needed (build it with no_lock.c).
+ *
+ *     Writers (insert/delete) find their position and lock only the
+ *     two nodes they change, pred and curr:
+ *       - default: optimistic, they walk the list without locks, lock
+ *         pred and curr and validate that both are still in the list
+ *         and adjacent; if not, they walk again.
+ *       - -DHOH_COUPLING: hand-over-hand, they walk holding the locks,
+ *         always locking the next node before releasing the previous.
+ *     Readers (member) never lock: a node is marked deleted before it
+ *     is unlinked, so a reader checks the mark of the node it stops at.
+ *
+ * Notes:
+ *     1. Two sentinels (head and tail) hold the smallest and the largest
+ *        int, so pred and curr always exist.
+ *     2. Nodes are locked in list order, so two writers cannot deadlock.
+ *     3. Unlinked nodes are freed through the epochs (epoch.c): an
+ *        unlocked reader may still be standing on them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "helpers.h"
+
+typedef struct hoh_node_tag{
+    int data;
+    _Atomic int marked;  // 1: deleted, set before the node is unlinked
+    pthread_mutex_t lock;
+    struct hoh_node_tag *_Atomic next;
+}hoh_node_s;
+
+static hoh_node_s tail = {INT_MAX, 0, PTHREAD_MUTEX_INITIALIZER, NULL};
+static hoh_node_s head = {INT_MIN, 0, PTHREAD_MUTEX_INITIALIZER, &tail};
+
+/* ------------------ Local Helpers ------------------ */
+static void Free_node(void *ptr){
+    hoh_node_s *node = ptr;
+    pthread_mutex_destroy(&node->lock);
+    NODE_FREE(node, sizeof(hoh_node_s));
+}
+
+static inline hoh_node_s *Next(hoh_node_s *node){
+    return atomic_load_explicit(&node->next, memory_order_acquire);
+}
+
+/* Returns with pred and curr locked, adjacent, in the list and
+ * pred->data < value <= curr->data. */
+static void Lock_window(int value, hoh_node_s **pred_p, hoh_node_s **curr_p){
+    hoh_node_s *pred, *curr;
+
+#ifdef HOH_COUPLING
+    pred = &head;
+    pthread_mutex_lock(&pred->lock);
+    curr = Next(pred);
+    pthread_mutex_lock(&curr->lock);
+    while (curr->data < value){
+        pthread_mutex_unlock(&pred->lock);
+        pred = curr;
+        curr = Next(curr);
+        pthread_mutex_lock(&curr->lock);
+    }
+#else
+    for (;;){
+        pred = &head;
+        curr = Next(pred);
+        while (curr->data < value){
+            pred = curr;
+            curr = Next(curr);
+        }
+        pthread_mutex_lock(&pred->lock);
+        pthread_mutex_lock(&curr->lock);
+// Validation: nobody deleted them or inserted between them meanwhile
+        if (!atomic_load(&pred->marked) && !atomic_load(&curr->marked) && Next(pred) == curr)
+            break;
+        pthread_mutex_unlock(&curr->lock);
+        pthread_mutex_unlock(&pred->lock);
+    }
+#endif
+    *pred_p = pred;
+    *curr_p = curr;
+}
+
+static void Unlock_window(hoh_node_s *pred, hoh_node_s *curr){
+    pthread_mutex_unlock(&curr->lock);
+    pthread_mutex_unlock(&pred->lock);
+}
+
+/*------------------- Insert Node Operation ------------------- */
+/* If value is not in list, return 1, else return 0 */
+static int HOH_insert(int value){
+    hoh_node_s *pred, *curr, *temp;
+    int rv = 1;
+
+    Epoch_enter();
+    Lock_window(value, &pred, &curr);
+    if (curr->data == value) /* value in list */
+        rv = 0;
+    else{
+        temp = NODE_ALLOC(sizeof(hoh_node_s));
+        temp->data = value;
+        temp->marked = 0;
+        pthread_mutex_init(&temp->lock, NULL);
+        atomic_store_explicit(&temp->next, curr, memory_order_relaxed);
+// Readers may follow pred->next right away: publish the node initialized
+        atomic_store_explicit(&pred->next, temp, memory_order_release);
+    }
+    Unlock_window(pred, curr);
+    Epoch_exit();
+
+    return rv;
+}
+
+/*-------------------- Member Operation ----------------------- */
+static int HOH_member(int value){
+    hoh_node_s *curr;
+    int rv;
+
+    Epoch_enter();
+    curr = Next(&head);
+    while (curr->data < value)
+        curr = Next(curr);
+    rv = curr->data == value && !atomic_load_explicit(&curr->marked, memory_order_acquire);
+    Epoch_exit();
+
+    return rv;
+}
+
+/*--------------------- Delete Node Operation --------------------- */
+/* If value is in list, return 1, else return 0 */
+static int HOH_delete(int value){
+    hoh_node_s *pred, *curr;
+    int rv = 0;
+
+    Epoch_enter();
+    Lock_window(value, &pred, &curr);
+    if (curr != &tail && curr->data == value){
+        atomic_store_explicit(&curr->marked, 1, memory_order_release);
+        atomic_store_explicit(&pred->next, Next(curr), memory_order_release);
+        rv = 1;
+    }
+    Unlock_window(pred, curr);
+    if (rv)
+        Epoch_retire(curr, Free_node);
+    Epoch_exit();
+
+    return rv;
+}
+
+/*------------------ Count the Nodes --------------------*/
+static int HOH_size(void){
+    int i = 0;
+
+    Epoch_enter();
+    for (hoh_node_s *curr = Next(&head); curr != &tail; curr = Next(curr))
+        if (!atomic_load(&curr->marked))
+            i++;
+    Epoch_exit();
+    return i;
+}
+
+/*------------------ Free-List Operation --------------------*/
+/* No threads are running: frees the list and the retired nodes */
+static void HOH_free(void){
+    hoh_node_s *curr = Next(&head), *following;
+
+    while (curr != &tail){
+        following = Next(curr);
+        Free_node(curr);
+        curr = following;
+    }
+    atomic_store(&head.next, &tail);
+    Epoch_drain();
+}
+
+const list_impl_s list_impl = {
+#ifdef HOH_COUPLING
+    .name = "hoh_list (lock coupling)",
+#else
+    .name = "hoh_list (optimistic)",
+#endif
+    .concurrent = 1,
+    .insert = HOH_insert,
+    .member = HOH_member,
+    .delete = HOH_delete,
+    .size = HOH_size,
+    .free_list = HOH_free,
+};
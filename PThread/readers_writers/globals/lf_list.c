@@ -0,0 +1,193 @@
+/* Purpose:
+ *     A lock-free sorted linked list of ints (Harris-Michael). No gate
+ *     is needed (build it with no_lock.c): readers never write shared
+ *     memory and writers only compare-and-swap one or two pointers.
+ *
+ * Notes:
+ *     1. Delete first marks the node, setting the low bit of its next
+ *        pointer, so that nothing can be inserted after it any more,
+ *        and then unlinks it. Any thread that walks over a marked
+ *        node unlinks it on the way (Find).
+ *     2. Unlinked nodes are freed through the epochs (epoch.c), so a
+ *        reader that is still standing on one never reads freed memory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "helpers.h"
+
+#define MARK 1UL
+
+typedef struct lf_node_tag{
+    int data;
+    _Atomic uintptr_t next;  // next node | MARK when this node is deleted
+}lf_node_s;
+
+static _Atomic uintptr_t head = 0;
+
+/* ------------------ Local Helpers ------------------ */
+static inline lf_node_s *Ptr(uintptr_t link){
+    return (lf_node_s *)(link & ~MARK);
+}
+
+static void Free_node(void *node){
+    NODE_FREE(node, sizeof(lf_node_s));
+}
+
+/* Finds the first node with data >= value. On return *pred_link is the
+ * link that points to it (head or the next of an unmarked node) and
+ * *curr_p the node itself (NULL at the end). Marked nodes met on the
+ * way are unlinked. */
+static void Find(int value, _Atomic uintptr_t **pred_link, lf_node_s **curr_p){
+    _Atomic uintptr_t *pred;
+    lf_node_s *curr;
+    uintptr_t next;
+
+retry:
+    pred = &head;
+    curr = Ptr(atomic_load_explicit(pred, memory_order_acquire));
+    while (curr != NULL){
+        next = atomic_load_explicit(&curr->next, memory_order_acquire);
+        if (next & MARK){
+            uintptr_t expected = (uintptr_t)curr;
+// pred changed (or was marked itself): start again
+            if (!atomic_compare_exchange_strong(pred, &expected, next & ~MARK))
+                goto retry;
+            Epoch_retire(curr, Free_node);
+            curr = Ptr(next);
+            continue;
+        }
+        if (curr->data >= value)
+            break;
+        pred = &curr->next;
+        curr = Ptr(next);
+    }
+    *pred_link = pred;
+    *curr_p = curr;
+}
+
+/*------------------- Insert Node Operation ------------------- */
+/* If value is not in list, return 1, else return 0 */
+static int LF_insert(int value){
+    _Atomic uintptr_t *pred;
+    lf_node_s *curr, *temp = NULL;
+    int rv;
+
+    Epoch_enter();
+    for (;;){
+        Find(value, &pred, &curr);
+        if (curr != NULL && curr->data == value){ /* value in list */
+            rv = 0;
+            break;
+        }
+        if (temp == NULL){
+            temp = NODE_ALLOC(sizeof(lf_node_s));
+            temp->data = value;
+        }
+        atomic_store_explicit(&temp->next, (uintptr_t)curr, memory_order_relaxed);
+
+        uintptr_t expected = (uintptr_t)curr;
+        if (atomic_compare_exchange_strong(pred, &expected, (uintptr_t)temp)){
+            temp = NULL;
+            rv = 1;
+            break;
+        }
+    }
+    Epoch_exit();
+    if (temp != NULL)  // only when the value was inserted by another thread meanwhile
+        Free_node(temp);
+
+    return rv;
+}
+
+/*-------------------- Member Operation ----------------------- */
+/* Wait-free: walks over the marked nodes without helping */
+static int LF_member(int value){
+    lf_node_s *curr;
+    int rv;
+
+    Epoch_enter();
+    curr = Ptr(atomic_load_explicit(&head, memory_order_acquire));
+    while (curr != NULL && curr->data < value)
+        curr = Ptr(atomic_load_explicit(&curr->next, memory_order_acquire));
+    rv = curr != NULL && curr->data == value &&
+         !(atomic_load_explicit(&curr->next, memory_order_acquire) & MARK);
+    Epoch_exit();
+
+    return rv;
+}
+
+/*--------------------- Delete Node Operation --------------------- */
+/* If value is in list, return 1, else return 0 */
+static int LF_delete(int value){
+    _Atomic uintptr_t *pred;
+    lf_node_s *curr;
+    uintptr_t next;
+    int rv;
+
+    Epoch_enter();
+    for (;;){
+        Find(value, &pred, &curr);
+        if (curr == NULL || curr->data != value){ /* Not in list */
+            rv = 0;
+            break;
+        }
+        next = atomic_load_explicit(&curr->next, memory_order_acquire);
+        if (next & MARK)
+            continue;  // another thread is deleting it, Find will unlink it
+// 1. Logical delete: mark the node
+        if (!atomic_compare_exchange_strong(&curr->next, &next, next | MARK))
+            continue;
+// 2. Physical delete: unlink it, or leave it to the next Find
+        uintptr_t expected = (uintptr_t)curr;
+        if (atomic_compare_exchange_strong(pred, &expected, next))
+            Epoch_retire(curr, Free_node);
+        else
+            Find(value, &pred, &curr);
+        rv = 1;
+        break;
+    }
+    Epoch_exit();
+
+    return rv;
+}
+
+/*------------------ Count the Nodes --------------------*/
+static int LF_size(void){
+    int i = 0;
+
+    Epoch_enter();
+    for (uintptr_t link = atomic_load(&head); Ptr(link) != NULL; link = atomic_load(&Ptr(link)->next))
+        if (!(atomic_load(&Ptr(link)->next) & MARK))
+            i++;
+    Epoch_exit();
+    return i;
+}
+
+/*------------------ Free-List Operation --------------------*/
+/* No threads are running: frees the list and the retired nodes */
+static void LF_free(void){
+    lf_node_s *curr = Ptr(atomic_load(&head)), *following;
+
+    while (curr != NULL){
+        following = Ptr(atomic_load(&curr->next));
+        Free_node(curr);
+        curr = following;
+    }
+    atomic_store(&head, 0);
+    Epoch_drain();
+}
+
+const list_impl_s list_impl = {
+    .name = "lf_list",
+    .concurrent = 1,
+    .insert = LF_insert,
+    .member = LF_member,
+    .delete = LF_delete,
+    .size = LF_size,
+    .free_list = LF_free,
+};
@@ -0,0 +1,231 @@
+/* Purpose:
+ *     The sorted linked list of ints: insert, member, delete, free.
+ *     The list is not thread-safe, the reader-writer gate of the
+ *     policy (priorityR.c, priorityW.c) protects it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "helpers.h"
+
+
+static list_node_s *head = NULL;
+
+/*------------------- Insert Node Operation ------------------- */
+/* Insert value in correct numerical location into list */
+/* If value is not in list, return 1, else return 0 */
+static int List_insert(int value){
+    list_node_s *curr = head;
+    list_node_s *pred = NULL;
+    list_node_s *temp;
+    int rv = 1;
+
+    while (curr != NULL && curr->data < value){
+        pred = curr;
+        curr = curr->next;
+    }
+
+    if (curr == NULL || curr->data > value){
+        temp = NODE_ALLOC(sizeof(list_node_s));
+        temp->data = value;
+        temp->next = curr;
+        if (pred == NULL)
+            head = temp;
+        else
+            pred->next = temp;
+    }
+    else{ /* value in list */
+        rv = 0;
+    }
+
+    return rv;
+}
+
+/*-----------------------------------------------------------------*/
+static int List_member(int value){
+    list_node_s *temp;
+    temp = head;
+
+    while (temp != NULL && temp->data < value)
+        temp = temp->next;
+
+    if (temp == NULL || temp->data > value){
+#ifdef DEBUG
+        printf("%d is not in the list\n", value);
+#endif
+        return 0;
+    }
+    else{
+#ifdef DEBUG
+        printf("%d is in the list\n", value);
+#endif
+        return 1;
+    }
+}
+/*--------------------- Delete Node Operation --------------------- */
+/* Deletes value from list */
+/* If value is in list, return 1, else return 0 */
+static int List_delete(int value){
+    list_node_s *curr = head;
+    list_node_s *pred = NULL;
+    int rv = 1;
+
+    while (curr != NULL && curr->data < value){
+        pred = curr;
+        curr = curr->next;
+    }
+
+    if (curr != NULL && curr->data == value){
+        if (pred == NULL){ /* first element in list */
+            head = curr->next;
+#ifdef DEBUG
+            printf("Freeing %d\n", value);
+#endif
+            NODE_FREE(curr, sizeof(list_node_s));
+        }
+        else{
+            pred->next = curr->next;
+#ifdef DEBUG
+            printf("Freeing %d\n", value);
+#endif
+            NODE_FREE(curr, sizeof(list_node_s));
+        }
+    }
+    else{ /* Not in list */
+        rv = 0;
+    }
+
+    return rv;
+} /* Delete */
+
+/*------------------ Batch of Writes --------------------*/
+/* reqs are sorted by value: one walk from head applies them all. The
+ * walk stays at pred->data < value, so equal values apply in order. */
+static void List_apply_batch(write_req_s *reqs, int n){
+    list_node_s *curr = head;
+    list_node_s *pred = NULL;
+    list_node_s *temp;
+
+    for (int i = 0; i < n; i++){
+        int value = reqs[i].value;
+
+        while (curr != NULL && curr->data < value){
+            pred = curr;
+            curr = curr->next;
+        }
+        if (reqs[i].op == OP_INSERT){
+            reqs[i].result = curr == NULL || curr->data > value;
+            if (reqs[i].result){
+                temp = NODE_ALLOC(sizeof(list_node_s));
+                temp->data = value;
+                temp->next = curr;
+                if (pred == NULL)
+                    head = temp;
+                else
+                    pred->next = temp;
+                curr = temp;
+            }
+        }
+        else{
+            reqs[i].result = curr != NULL && curr->data == value;
+            if (reqs[i].result){
+                temp = curr;
+                curr = curr->next;
+                if (pred == NULL)
+                    head = curr;
+                else
+                    pred->next = curr;
+                NODE_FREE(temp, sizeof(list_node_s));
+            }
+        }
+    }
+}
+
+/*------------------ Batch of Lookups --------------------*/
+/* keys are sorted: a merge of the keys with the list, one walk */
+static void List_member_batch(const int *keys, int *found, int n){
+    list_node_s *curr = head;
+
+    for (int i = 0; i < n; i++){
+        while (curr != NULL && curr->data < keys[i])
+            curr = curr->next;
+        found[i] = curr != NULL && curr->data == keys[i];
+    }
+}
+
+/*------------------ Range Scan --------------------*/
+/* The caller holds the read gate, so the keys are a snapshot */
+static int List_range(int lo, int hi, int *keys, int max){
+    list_node_s *curr = head;
+    int n = 0;
+
+    while (curr != NULL && curr->data < lo)
+        curr = curr->next;
+    for (; curr != NULL && curr->data <= hi; curr = curr->next, n++)
+        if (n < max)
+            keys[n] = curr->data;
+    return n;
+}
+
+/*------------------ Bulk Load --------------------*/
+/* The list is empty, keys are sorted and distinct: link them in order */
+static void List_bulk_load(const int *keys, int n){
+    list_node_s **tail = &head;
+
+    for (int i = 0; i < n; i++){
+        list_node_s *temp = NODE_ALLOC(sizeof(list_node_s));
+        temp->data = keys[i];
+        *tail = temp;
+        tail = &temp->next;
+    }
+    *tail = NULL;
+}
+
+/*------------------ Count the Nodes --------------------*/
+static int List_size(void){
+    int i = 0;
+
+    for (list_node_s *temp = head; temp != NULL; temp = temp->next)
+        i++;
+    return i;
+}
+
+/*------------------ Free-List Operation --------------------*/
+static void List_free(void){
+    list_node_s *current;
+    list_node_s *following;
+
+    if (head == NULL)
+        return;
+    current = head;
+    following = current->next;
+    while (following != NULL){
+#ifdef DEBUG
+        printf("Freeing %d\n", current->data);
+#endif
+        NODE_FREE(current, sizeof(list_node_s));
+        current = following;
+        following = current->next;
+    }
+#ifdef DEBUG
+    printf("Freeing %d\n", current->data);
+#endif
+    NODE_FREE(current, sizeof(list_node_s));
+    head = NULL;
+}
+
+const list_impl_s list_impl = {
+    .name = "list",
+    .concurrent = 0,
+    .insert = List_insert,
+    .member = List_member,
+    .delete = List_delete,
+    .size = List_size,
+    .free_list = List_free,
+    .apply_batch = List_apply_batch,
+    .member_batch = List_member_batch,
+    .bulk_load = List_bulk_load,
+    .range = List_range,
+};
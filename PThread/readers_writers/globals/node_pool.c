@@ -0,0 +1,205 @@
+/* Purpose:
+ *     A per-thread pool allocator for the list nodes, used instead of
+ *     malloc/free when the program is built with -DNODE_POOL
+ *     (make build ... POOL=1).
+ *
+ *     Pool_alloc / Pool_free:  take / give back a node of `size` bytes
+ *     Node_pool_destroy:       frees all the memory (no threads running)
+ *
+ * Notes:
+ *     1. Every thread keeps its own free lists, one per size class, so
+ *        allocating and freeing inside the critical section take no
+ *        lock at all.
+ *     2. Nodes are carved out of 64 KB slabs aligned to a cache line.
+ *        The size classes are 16, 32, 64 bytes and then multiples of
+ *        64, so a node never straddles more cache lines than it needs,
+ *        and the nodes a thread inserts one after the other sit next
+ *        to each other in memory.
+ *     3. A thread that frees much more than it allocates (it deletes
+ *        the nodes others inserted) returns them in batches of
+ *        POOL_BATCH to a central list, one lock per batch; a thread
+ *        with an empty free list takes a batch from there before it
+ *        carves a new slab.
+ *     4. Nodes larger than POOL_MAX_SIZE come from malloc.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "helpers.h"
+
+#define CACHE_LINE 64
+#define POOL_SLAB_SIZE (64 * 1024)
+#define POOL_MAX_SIZE 512
+#define POOL_CLASSES 10            // 16, 32, 64, 128, 192, ..., 512
+#define POOL_BATCH 64              // nodes moved at once to the central list
+#define POOL_HIGH (4 * POOL_BATCH) // local free nodes that trigger a return
+
+/* A free node: the link of its free list, and of its batch on the
+ * central list (only in the first node of a batch) */
+typedef struct free_node_tag{
+    struct free_node_tag *next;
+    struct free_node_tag *next_batch;
+}free_node_s;
+
+typedef struct{
+    free_node_s *head;
+    int count;
+}free_list_s;
+
+/* One per thread, indexed by thread_rank */
+typedef struct{
+    free_list_s lists[POOL_CLASSES];
+}__attribute__((aligned(CACHE_LINE))) thread_cache_s;
+
+typedef struct{
+    pthread_mutex_t mtx;
+    free_node_s *batches;
+}central_list_s;
+
+/* The first cache line of every slab links it to the others */
+typedef struct slab_tag{
+    struct slab_tag *next;
+}slab_s;
+
+static thread_cache_s caches[MAX_THREADS];
+static central_list_s central[POOL_CLASSES];
+static slab_s *slabs = NULL;
+static pthread_mutex_t slab_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t central_once = PTHREAD_ONCE_INIT;
+
+/* ------------------ Local Helpers ------------------ */
+static void Init_central(void){
+    for (int c = 0; c < POOL_CLASSES; c++){
+        pthread_mutex_init(&central[c].mtx, NULL);
+        central[c].batches = NULL;
+    }
+}
+
+static int Size_class(size_t size){
+    if (size <= 16)
+        return 0;
+    if (size <= 32)
+        return 1;
+    if (size <= 64)
+        return 2;
+    return 1 + (int)((size + CACHE_LINE - 1) / CACHE_LINE);
+}
+
+static size_t Class_size(int c){
+    return c < 3 ? (size_t)16 << c : (size_t)(c - 1) * CACHE_LINE;
+}
+
+/* Fills an empty free list: a batch from the central list, or a new slab */
+static void Refill(int c, free_list_s *list){
+    central_list_s *cl = &central[c];
+    size_t size = Class_size(c);
+    char *slab, *node;
+
+    pthread_once(&central_once, Init_central);
+    pthread_mutex_lock(&cl->mtx);
+    if (cl->batches != NULL){
+        list->head = cl->batches;
+        cl->batches = cl->batches->next_batch;
+        pthread_mutex_unlock(&cl->mtx);
+        list->count = POOL_BATCH;
+        return;
+    }
+    pthread_mutex_unlock(&cl->mtx);
+
+    if (posix_memalign((void **)&slab, CACHE_LINE, POOL_SLAB_SIZE) != 0){
+        perror("Pool_alloc");
+        exit(EXIT_FAILURE);
+    }
+    pthread_mutex_lock(&slab_mtx);
+    ((slab_s *)slab)->next = slabs;
+    slabs = (slab_s *)slab;
+    pthread_mutex_unlock(&slab_mtx);
+
+// Link the nodes in address order, so they are handed out in that order
+    list->head = NULL;
+    list->count = 0;
+    for (node = slab + POOL_SLAB_SIZE - size; node >= slab + CACHE_LINE; node -= size){
+        ((free_node_s *)node)->next = list->head;
+        list->head = (free_node_s *)node;
+        list->count++;
+    }
+}
+
+/* Moves POOL_BATCH nodes from a long free list to the central list */
+static void Return_batch(int c, free_list_s *list){
+    central_list_s *cl = &central[c];
+    free_node_s *first = list->head, *last = first;
+
+    for (int i = 1; i < POOL_BATCH; i++)
+        last = last->next;
+    list->head = last->next;
+    list->count -= POOL_BATCH;
+    last->next = NULL;
+
+    pthread_once(&central_once, Init_central);
+    pthread_mutex_lock(&cl->mtx);
+    first->next_batch = cl->batches;
+    cl->batches = first;
+    pthread_mutex_unlock(&cl->mtx);
+}
+
+/*------------------- Allocate a Node ------------------- */
+void *Pool_alloc(size_t size){
+    free_list_s *list;
+    free_node_s *node;
+    int c;
+
+    if (size > POOL_MAX_SIZE)
+        return malloc(size);
+    c = Size_class(size);
+    list = &caches[thread_rank].lists[c];
+    if (list->head == NULL)
+        Refill(c, list);
+    node = list->head;
+    list->head = node->next;
+    list->count--;
+
+    return node;
+}
+
+/*------------------- Free a Node ------------------- */
+void Pool_free(void *ptr, size_t size){
+    free_list_s *list;
+    free_node_s *node = ptr;
+    int c;
+
+    if (ptr == NULL)
+        return;
+    if (size > POOL_MAX_SIZE){
+        free(ptr);
+        return;
+    }
+    c = Size_class(size);
+    list = &caches[thread_rank].lists[c];
+    node->next = list->head;
+    list->head = node;
+    if (++list->count >= POOL_HIGH)
+        Return_batch(c, list);
+}
+
+/*------------------- Free All the Slabs ------------------- */
+/* Only when no thread uses the pool any more */
+void Node_pool_destroy(void){
+    slab_s *slab = slabs, *following;
+
+    while (slab != NULL){
+        following = slab->next;
+        free(slab);
+        slab = following;
+    }
+    slabs = NULL;
+    for (int t = 0; t < MAX_THREADS; t++)
+        for (int c = 0; c < POOL_CLASSES; c++){
+            caches[t].lists[c].head = NULL;
+            caches[t].lists[c].count = 0;
+        }
+    for (int c = 0; c < POOL_CLASSES; c++)
+        central[c].batches = NULL;
+}
@@ -0,0 +1,303 @@
+/* Purpose:
+ *     A sorted linked list of ints in the style of RCU (read-copy-
+ *     update), for the read-mostly mixes. Build it with no_lock.c.
+ *
+ *     Member:  no lock and no write to shared memory: the reader only
+ *              announces its epoch in its own slot and walks the list
+ *     Insert / Delete:  serialized by one writer mutex. The new node is
+ *              fully built before a release store publishes it; a
+ *              deleted node is unlinked with one release store, keeps
+ *              its next pointer for the readers still on it, and is
+ *              freed after a grace period (Epoch_retire).
+ *     Range:   the keys in [lo, hi] as of one version of the list (a
+ *              snapshot), with no lock: long scans never hold up the
+ *              writers, and the writers never make a scan start over
+ *
+ * Notes:
+ *     1. Readers never wait for writers and writers never wait for
+ *        readers, so the read throughput grows with the threads.
+ *     2. The grace period comes from the epochs (epoch.c): a node is
+ *        freed once every reader that could have seen it has left.
+ *     3. Snapshots: every insert / delete makes a new version. A node
+ *        records the version that linked it and the one that unlinked
+ *        it; a scan at version S keeps the nodes with ins_ver <= S <
+ *        del_ver. A node gets its version number before it is linked /
+ *        unlinked, and the version is published after, so a scan that
+ *        reads version S finds every change up to S in the list.
+ *     4. A deleted node leaves the list, but a scan that started before
+ *        still needs it: the writer pushes it on the removed stack
+ *        before it unlinks it, and the scan looks there after its walk.
+ *        Every scan announces its version in its slot; once no scan is
+ *        older than the delete, the node is taken off the stack and
+ *        retired (Epoch_retire) as before.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "helpers.h"
+
+#define CACHE_LINE 64
+#define LIVE ULONG_MAX  // del_ver of a node still in the list
+
+typedef struct rcu_node_tag{
+    int data;
+    struct rcu_node_tag *_Atomic next;
+    unsigned long ins_ver;                       // the version that linked it
+    _Atomic unsigned long del_ver;               // the version that unlinked it
+    struct rcu_node_tag *_Atomic removed_next;   // on the removed stack
+}rcu_node_s;
+
+typedef struct{
+    _Atomic unsigned long version;  // of the running scan, 0: none
+}__attribute__((aligned(CACHE_LINE))) snap_slot_s;
+
+static rcu_node_s *_Atomic head = NULL;
+static pthread_mutex_t writer_mtx = PTHREAD_MUTEX_INITIALIZER;
+static _Atomic unsigned long version __attribute__((aligned(CACHE_LINE))) = 1;
+static rcu_node_s *_Atomic removed = NULL;  // deleted nodes, newest first
+static _Atomic int scanners = 0;            // scans running
+static snap_slot_s snap_slots[MAX_THREADS];
+
+/* ------------------ Local Helpers ------------------ */
+static void Free_node(void *node){
+    NODE_FREE(node, sizeof(rcu_node_s));
+}
+
+/* Writers only: takes off the removed stack the nodes that no running
+ * or later scan can need (deleted at or before the oldest scan) and
+ * returns them as a chain, to retire outside the critical section */
+static rcu_node_s *Trim_removed(void){
+    unsigned long oldest = atomic_load(&version);
+    rcu_node_s *_Atomic *link = &removed;
+    rcu_node_s *curr;
+
+    if (atomic_load(&scanners) > 0)
+        for (int t = 0; t < thread_count; t++){
+            unsigned long v = atomic_load(&snap_slots[t].version);
+            if (v != 0 && v < oldest)
+                oldest = v;
+        }
+    curr = atomic_load_explicit(link, memory_order_relaxed);
+    while (curr != NULL && atomic_load_explicit(&curr->del_ver, memory_order_relaxed) > oldest){
+        link = &curr->removed_next;
+        curr = atomic_load_explicit(link, memory_order_relaxed);
+    }
+    atomic_store_explicit(link, NULL, memory_order_relaxed);
+    return curr;
+}
+
+/* Writers only (writer_mtx held): nothing else changes the links, so
+ * relaxed loads are enough. Returns the link that points to the first
+ * node with data >= value. */
+static rcu_node_s *_Atomic *Writer_find(int value, rcu_node_s **curr_p){
+    rcu_node_s *_Atomic *pred = &head;
+    rcu_node_s *curr = atomic_load_explicit(pred, memory_order_relaxed);
+
+    while (curr != NULL && curr->data < value){
+        pred = &curr->next;
+        curr = atomic_load_explicit(pred, memory_order_relaxed);
+    }
+    *curr_p = curr;
+    return pred;
+}
+
+/*------------------- Insert Node Operation ------------------- */
+/* If value is not in list, return 1, else return 0 */
+static int RCU_insert(int value){
+    rcu_node_s *_Atomic *pred;
+    rcu_node_s *curr, *temp;
+    int rv = 1;
+
+    pthread_mutex_lock(&writer_mtx);
+    pred = Writer_find(value, &curr);
+    if (curr != NULL && curr->data == value) /* value in list */
+        rv = 0;
+    else{
+        unsigned long v = atomic_load_explicit(&version, memory_order_relaxed) + 1;
+
+        temp = NODE_ALLOC(sizeof(rcu_node_s));
+        temp->data = value;
+        temp->ins_ver = v;
+        atomic_store_explicit(&temp->del_ver, LIVE, memory_order_relaxed);
+        atomic_store_explicit(&temp->removed_next, NULL, memory_order_relaxed);
+        atomic_store_explicit(&temp->next, curr, memory_order_relaxed);
+// Publish: a reader that sees temp sees it initialized
+        atomic_store_explicit(pred, temp, memory_order_release);
+// The scans from version v on see it
+        atomic_store(&version, v);
+    }
+    pthread_mutex_unlock(&writer_mtx);
+
+    return rv;
+}
+
+/*-------------------- Member Operation ----------------------- */
+static int RCU_member(int value){
+    rcu_node_s *curr;
+    int rv;
+
+    Epoch_enter();
+    curr = atomic_load_explicit(&head, memory_order_acquire);
+    while (curr != NULL && curr->data < value)
+        curr = atomic_load_explicit(&curr->next, memory_order_acquire);
+    rv = curr != NULL && curr->data == value;
+    Epoch_exit();
+
+    return rv;
+}
+
+/*--------------------- Delete Node Operation --------------------- */
+/* If value is in list, return 1, else return 0 */
+static int RCU_delete(int value){
+    rcu_node_s *_Atomic *pred;
+    rcu_node_s *curr, *stale = NULL, *following;
+    int rv = 0;
+
+    pthread_mutex_lock(&writer_mtx);
+    pred = Writer_find(value, &curr);
+    if (curr != NULL && curr->data == value){
+        unsigned long v = atomic_load_explicit(&version, memory_order_relaxed) + 1;
+
+// The scans older than v still need curr: on the removed stack first
+        atomic_store_explicit(&curr->del_ver, v, memory_order_relaxed);
+        atomic_store_explicit(&curr->removed_next, atomic_load_explicit(&removed, memory_order_relaxed),
+                              memory_order_relaxed);
+        atomic_store_explicit(&removed, curr, memory_order_release);
+// Readers on curr still follow its next pointer to the rest of the list
+        atomic_store_explicit(pred, atomic_load_explicit(&curr->next, memory_order_relaxed),
+                              memory_order_release);
+        atomic_store(&version, v);
+        stale = Trim_removed();
+        rv = 1;
+    }
+    pthread_mutex_unlock(&writer_mtx);
+
+// Free them after a grace period, outside of the writer's critical section
+    for (; stale != NULL; stale = following){
+        following = atomic_load_explicit(&stale->removed_next, memory_order_relaxed);
+        Epoch_retire(stale, Free_node);
+    }
+
+    return rv;
+}
+
+/*------------------ Range Scan --------------------*/
+static int Compare_ints(const void *a, const void *b){
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/* Appends value to the growing array *keys */
+static void Push_key(int **keys, int *n, int *cap, int value){
+    if (*n == *cap){
+        *cap = *cap == 0 ? 64 : 2 * *cap;
+        if ((*keys = realloc(*keys, *cap * sizeof(int))) == NULL){
+            perror("RCU_range");
+            exit(EXIT_FAILURE);
+        }
+    }
+    (*keys)[(*n)++] = value;
+}
+
+/* The keys in [lo, hi] as of the version the scan starts at */
+static int RCU_range(int lo, int hi, int *keys, int max){
+    _Atomic unsigned long *slot = &snap_slots[thread_rank].version;
+    int *walked = NULL, *extra = NULL;
+    int n_walked = 0, walked_cap = 0, n_extra = 0, extra_cap = 0, n = 0;
+    unsigned long snap;
+    rcu_node_s *curr;
+
+    Epoch_enter();
+// Announce the version before using it: a writer that trims without
+// seeing the slot read the version before we did, and keeps our nodes
+    atomic_fetch_add(&scanners, 1);
+    do{
+        snap = atomic_load(&version);
+        atomic_store(slot, snap);
+    }while (atomic_load(&version) != snap);
+
+// 1. The list: the nodes linked at snap that are still there
+    curr = atomic_load_explicit(&head, memory_order_acquire);
+    while (curr != NULL && curr->data < lo)
+        curr = atomic_load_explicit(&curr->next, memory_order_acquire);
+    for (; curr != NULL && curr->data <= hi; curr = atomic_load_explicit(&curr->next, memory_order_acquire))
+        if (curr->ins_ver <= snap && atomic_load_explicit(&curr->del_ver, memory_order_relaxed) > snap)
+            Push_key(&walked, &n_walked, &walked_cap, curr->data);
+
+// 2. The removed stack, AFTER the walk: the nodes deleted since snap,
+// including those unlinked while we walked (newest first)
+    for (curr = atomic_load_explicit(&removed, memory_order_acquire);
+         curr != NULL && atomic_load_explicit(&curr->del_ver, memory_order_relaxed) > snap;
+         curr = atomic_load_explicit(&curr->removed_next, memory_order_acquire))
+        if (curr->ins_ver <= snap && curr->data >= lo && curr->data <= hi)
+            Push_key(&extra, &n_extra, &extra_cap, curr->data);
+
+    atomic_store(slot, 0);
+    atomic_fetch_sub(&scanners, 1);
+    Epoch_exit();
+
+// 3. Merge the two: a node seen in both is one key
+    qsort(extra, n_extra, sizeof(int), Compare_ints);
+    for (int i = 0, j = 0; i < n_walked || j < n_extra; n++){
+        int key;
+
+        if (j == n_extra || (i < n_walked && walked[i] < extra[j]))
+            key = walked[i++];
+        else if (i == n_walked || extra[j] < walked[i])
+            key = extra[j++];
+        else{
+            key = walked[i++];
+            j++;
+        }
+        if (n < max)
+            keys[n] = key;
+    }
+    free(walked);
+    free(extra);
+    return n;
+}
+
+/*------------------ Count the Nodes --------------------*/
+static int RCU_size(void){
+    int i = 0;
+
+    Epoch_enter();
+    for (rcu_node_s *curr = atomic_load(&head); curr != NULL; curr = atomic_load(&curr->next))
+        i++;
+    Epoch_exit();
+    return i;
+}
+
+/*------------------ Free-List Operation --------------------*/
+/* No threads are running: frees the list and the retired nodes */
+static void RCU_free(void){
+    rcu_node_s *curr = atomic_load(&head), *following;
+
+    while (curr != NULL){
+        following = atomic_load(&curr->next);
+        Free_node(curr);
+        curr = following;
+    }
+    atomic_store(&head, NULL);
+    for (curr = atomic_load(&removed); curr != NULL; curr = following){
+        following = atomic_load(&curr->removed_next);
+        Free_node(curr);
+    }
+    atomic_store(&removed, NULL);
+    Epoch_drain();
+}
+
+const list_impl_s list_impl = {
+    .name = "rcu_list",
+    .concurrent = 1,
+    .insert = RCU_insert,
+    .member = RCU_member,
+    .delete = RCU_delete,
+    .size = RCU_size,
+    .free_list = RCU_free,
+    .range = RCU_range,
+};
@@ -0,0 +1,241 @@
+/* Purpose:
+ *     A set of ints split by key range into shards, each one a sorted
+ *     list with its own read-write lock. Threads working on different
+ *     key ranges never meet, so with N shards the contention on every
+ *     lock drops roughly N times. Build it with no_lock.c.
+ *
+ *     Set_create / Set_destroy:  one independent set (many can coexist)
+ *     Set_insert / Set_member / Set_delete / Set_size:  the operations
+ *
+ *     list_impl runs the program on one set of shard_count shards
+ *     (option -s, 16 by default), created by list_impl.init once the
+ *     options are read and destroyed at exit. Free_list only empties it.
+ *
+ * Notes:
+ *     1. Shard i holds the keys [i * width, (i + 1) * width), so every
+ *        shard stays sorted and a walk only covers 1/N of the keys.
+ *     2. Every shard sits in its own cache lines: the lock of one shard
+ *        does not share a line with the lock of the next.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "helpers.h"
+
+#define CACHE_LINE 64
+
+typedef struct{
+    pthread_rwlock_t lock;
+    list_node_s *head;
+}__attribute__((aligned(CACHE_LINE))) shard_s;
+
+struct sharded_set_tag{
+    int shards;
+    long width;     // keys per shard
+    shard_s *shard;
+};
+
+static sharded_set_s *set = NULL;
+
+/* ------------------ Local Helpers ------------------ */
+static shard_s *Shard_of(sharded_set_s *s, int value){
+    long i = value < 0 ? 0 : value / s->width;
+    return &s->shard[i < s->shards ? i : s->shards - 1];
+}
+
+/* Returns the link that points to the first node with data >= value */
+static list_node_s **Find(shard_s *sh, int value){
+    list_node_s **pred = &sh->head;
+
+    while (*pred != NULL && (*pred)->data < value)
+        pred = &(*pred)->next;
+    return pred;
+}
+
+/* Frees the nodes of every shard; the locks stay */
+static void Set_empty(sharded_set_s *s){
+    list_node_s *curr, *following;
+
+    for (int i = 0; i < s->shards; i++){
+        for (curr = s->shard[i].head; curr != NULL; curr = following){
+            following = curr->next;
+            NODE_FREE(curr, sizeof(list_node_s));
+        }
+        s->shard[i].head = NULL;
+    }
+}
+
+/*------------------- Create / Destroy ------------------- */
+/* A set for keys in [0, max_key) split in `shards` ranges */
+sharded_set_s *Set_create(int shards, int max_key){
+    sharded_set_s *s = malloc(sizeof(sharded_set_s));
+
+    if (s == NULL || shards < 1 ||
+        posix_memalign((void **)&s->shard, CACHE_LINE, shards * sizeof(shard_s)) != 0){
+        free(s);
+        return NULL;
+    }
+    s->shards = shards;
+    s->width = ((long)max_key + shards - 1) / shards;
+    for (int i = 0; i < shards; i++){
+        pthread_rwlock_init(&s->shard[i].lock, NULL);
+        s->shard[i].head = NULL;
+    }
+    return s;
+}
+
+/* No thread may use the set any more */
+void Set_destroy(sharded_set_s *s){
+    Set_empty(s);
+    for (int i = 0; i < s->shards; i++)
+        pthread_rwlock_destroy(&s->shard[i].lock);
+    free(s->shard);
+    free(s);
+}
+
+/*------------------- Insert Node Operation ------------------- */
+/* If value is not in the set, return 1, else return 0 */
+int Set_insert(sharded_set_s *s, int value){
+    shard_s *sh = Shard_of(s, value);
+    list_node_s **pred, *temp;
+    int rv = 0;
+
+    pthread_rwlock_wrlock(&sh->lock);
+    pred = Find(sh, value);
+    if (*pred == NULL || (*pred)->data > value){
+        temp = NODE_ALLOC(sizeof(list_node_s));
+        temp->data = value;
+        temp->next = *pred;
+        *pred = temp;
+        rv = 1;
+    }
+    pthread_rwlock_unlock(&sh->lock);
+
+    return rv;
+}
+
+/*-------------------- Member Operation ----------------------- */
+int Set_member(sharded_set_s *s, int value){
+    shard_s *sh = Shard_of(s, value);
+    list_node_s *curr;
+    int rv;
+
+    pthread_rwlock_rdlock(&sh->lock);
+    curr = *Find(sh, value);
+    rv = curr != NULL && curr->data == value;
+    pthread_rwlock_unlock(&sh->lock);
+
+    return rv;
+}
+
+/*--------------------- Delete Node Operation --------------------- */
+/* If value is in the set, return 1, else return 0 */
+int Set_delete(sharded_set_s *s, int value){
+    shard_s *sh = Shard_of(s, value);
+    list_node_s **pred, *curr;
+    int rv = 0;
+
+    pthread_rwlock_wrlock(&sh->lock);
+    pred = Find(sh, value);
+    curr = *pred;
+    if (curr != NULL && curr->data == value){
+        *pred = curr->next;
+        NODE_FREE(curr, sizeof(list_node_s));
+        rv = 1;
+    }
+    pthread_rwlock_unlock(&sh->lock);
+
+    return rv;
+}
+
+/*------------------ Count the Nodes --------------------*/
+int Set_size(sharded_set_s *s){
+    int n = 0;
+
+    for (int i = 0; i < s->shards; i++){
+        pthread_rwlock_rdlock(&s->shard[i].lock);
+        for (list_node_s *curr = s->shard[i].head; curr != NULL; curr = curr->next)
+            n++;
+        pthread_rwlock_unlock(&s->shard[i].lock);
+    }
+    return n;
+}
+
+/* ------------------ The Program's Set ------------------ */
+/* main calls it once, after -s and before any operation */
+static void Sharded_init(void){
+    if ((set = Set_create(shard_count, MAX_KEY)) == NULL){
+        fprintf(stderr, "Cannot create a set of %d shards\n", shard_count);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* The last Free_list emptied the set (the nodes may live in the node
+ * pool, which is gone by now): only the locks and the shards are left */
+__attribute__((destructor)) static void Destroy_set(void){
+    if (set == NULL)
+        return;
+    for (int i = 0; i < set->shards; i++)
+        pthread_rwlock_destroy(&set->shard[i].lock);
+    free(set->shard);
+    free(set);
+    set = NULL;
+}
+
+static int Sharded_insert(int value){
+    return Set_insert(set, value);
+}
+
+static int Sharded_member(int value){
+    return Set_member(set, value);
+}
+
+static int Sharded_delete(int value){
+    return Set_delete(set, value);
+}
+
+static int Sharded_size(void){
+    return Set_size(set);
+}
+
+/* The set is empty, keys are sorted and distinct: each shard gets its
+ * range of keys linked in order. No threads are running. */
+static void Sharded_bulk_load(const int *keys, int n){
+    sharded_set_s *s = set;
+    list_node_s **tail = NULL;
+    shard_s *last = NULL;
+
+    for (int i = 0; i < n; i++){
+        shard_s *sh = Shard_of(s, keys[i]);
+        list_node_s *temp = NODE_ALLOC(sizeof(list_node_s));
+
+        if (sh != last){
+            tail = &sh->head;
+            last = sh;
+        }
+        temp->data = keys[i];
+        temp->next = NULL;
+        *tail = temp;
+        tail = &temp->next;
+    }
+}
+
+/* No threads are running: the shards and their locks stay for the
+ * next fill (-S refills) */
+static void Sharded_free(void){
+    Set_empty(set);
+}
+
+const list_impl_s list_impl = {
+    .name = "sharded_list",
+    .concurrent = 1,
+    .init = Sharded_init,
+    .insert = Sharded_insert,
+    .member = Sharded_member,
+    .delete = Sharded_delete,
+    .size = Sharded_size,
+    .free_list = Sharded_free,
+    .bulk_load = Sharded_bulk_load,
+};
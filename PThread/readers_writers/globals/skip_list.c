@@ -0,0 +1,309 @@
+/* Purpose:
+ *     A concurrent skip list of ints (the "lazy" skip list of Herlihy,
+ *     Lev, Luchangco and Shavit) with the operations of the sorted
+ *     list: O(log n) instead of O(n), and no gate needed (build it
+ *     with no_lock.c).
+ *
+ *     Member:  lock-free, walks down the levels without locking
+ *     Insert:  locks the predecessors of the new node on its levels,
+ *              validates them and links the node bottom-up
+ *     Delete:  locks and marks the node (logical delete), then locks
+ *              its predecessors and unlinks it top-down
+ *
+ * Notes:
+ *     1. A node is in the set once it is fully linked and as long as it
+ *        is not marked.
+ *     2. Every node gets a random height: level l with probability
+ *        1/2^l, up to MAX_LEVEL.
+ *     3. Unlinked nodes are freed through the epochs (epoch.c).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "../../../helpers/my_rand.h"
+
+#include "helpers.h"
+
+/* 2^MAX_LEVEL keys before the top level gets crowded */
+#define MAX_LEVEL 24
+
+typedef struct skip_node_tag{
+    int data;
+    int top_level;
+    _Atomic int marked;
+    _Atomic int fully_linked;
+    pthread_mutex_t lock;
+    struct skip_node_tag *_Atomic next[];  // top_level + 1 links
+}skip_node_s;
+
+static skip_node_s *head, *tail;
+static __thread unsigned level_seed = 0;
+
+/* ------------------ Local Helpers ------------------ */
+static size_t Node_size(int top_level){
+    return sizeof(skip_node_s) + (top_level + 1) * sizeof(skip_node_s *);
+}
+
+static skip_node_s *Init_node(skip_node_s *node, int value, int top_level){
+    node->data = value;
+    node->top_level = top_level;
+    node->marked = 0;
+    node->fully_linked = 0;
+    pthread_mutex_init(&node->lock, NULL);
+    return node;
+}
+
+static skip_node_s *New_node(int value, int top_level){
+    return Init_node(NODE_ALLOC(Node_size(top_level)), value, top_level);
+}
+
+static void Free_node(void *ptr){
+    skip_node_s *node = ptr;
+    pthread_mutex_destroy(&node->lock);
+    NODE_FREE(node, Node_size(node->top_level));
+}
+
+/* The sentinels exist before main runs (and outlive the node pool) */
+__attribute__((constructor)) static void Init_sentinels(void){
+    head = Init_node(malloc(Node_size(MAX_LEVEL - 1)), INT_MIN, MAX_LEVEL - 1);
+    tail = Init_node(malloc(Node_size(MAX_LEVEL - 1)), INT_MAX, MAX_LEVEL - 1);
+    for (int l = 0; l < MAX_LEVEL; l++){
+        atomic_init(&head->next[l], tail);
+        atomic_init(&tail->next[l], NULL);
+    }
+    head->fully_linked = tail->fully_linked = 1;
+}
+
+__attribute__((destructor)) static void Free_sentinels(void){
+    pthread_mutex_destroy(&head->lock);
+    pthread_mutex_destroy(&tail->lock);
+    free(head);
+    free(tail);
+}
+
+static inline skip_node_s *Next(skip_node_s *node, int level){
+    return atomic_load_explicit(&node->next[level], memory_order_acquire);
+}
+
+static int Random_level(void){
+    int level = 0;
+
+    if (level_seed == 0)
+        level_seed = my_seed(thread_rank + 1);
+    for (unsigned bits = my_rand(&level_seed); (bits & 1) && level < MAX_LEVEL - 1; bits >>= 1)
+        level++;
+    return level;
+}
+
+/* Fills preds/succs on every level: preds[l]->data < value <= succs[l]->data.
+ * Returns the highest level where succs[l] holds value, or -1. */
+static int Find(int value, skip_node_s *preds[], skip_node_s *succs[]){
+    int found = -1;
+    skip_node_s *pred = head, *curr;
+
+    for (int level = MAX_LEVEL - 1; level >= 0; level--){
+        curr = Next(pred, level);
+        while (curr->data < value){
+            pred = curr;
+            curr = Next(pred, level);
+        }
+        if (found == -1 && curr->data == value)
+            found = level;
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+    return found;
+}
+
+/* Unlocks the distinct predecessors on levels 0..highest */
+static void Unlock_preds(skip_node_s *preds[], int highest){
+    skip_node_s *prev = NULL;
+
+    for (int level = 0; level <= highest; level++){
+        if (preds[level] != prev)
+            pthread_mutex_unlock(&preds[level]->lock);
+        prev = preds[level];
+    }
+}
+
+/*------------------- Insert Node Operation ------------------- */
+/* If value is not in list, return 1, else return 0 */
+static int Skip_insert(int value){
+    skip_node_s *preds[MAX_LEVEL], *succs[MAX_LEVEL];
+    int top_level = Random_level();
+    int rv;
+
+    Epoch_enter();
+    for (;;){
+        int found = Find(value, preds, succs);
+        if (found != -1){
+            skip_node_s *node = succs[found];
+            if (!atomic_load(&node->marked)){ /* value in list */
+// Wait until the other insert is done, so a following Member finds it
+                while (!atomic_load(&node->fully_linked))
+                    sched_yield();
+                rv = 0;
+                break;
+            }
+            continue;  // being deleted: try again
+        }
+
+// Lock the predecessors bottom-up and validate them
+        int highest = -1, valid = 1;
+        skip_node_s *prev = NULL;
+        for (int level = 0; valid && level <= top_level; level++){
+            skip_node_s *pred = preds[level], *succ = succs[level];
+            if (pred != prev){
+                pthread_mutex_lock(&pred->lock);
+                prev = pred;
+            }
+            highest = level;
+            valid = !atomic_load(&pred->marked) && !atomic_load(&succ->marked) &&
+                    Next(pred, level) == succ;
+        }
+        if (!valid){
+            Unlock_preds(preds, highest);
+            continue;
+        }
+
+        skip_node_s *temp = New_node(value, top_level);
+        for (int level = 0; level <= top_level; level++)
+            atomic_store_explicit(&temp->next[level], succs[level], memory_order_relaxed);
+        for (int level = 0; level <= top_level; level++)
+            atomic_store_explicit(&preds[level]->next[level], temp, memory_order_release);
+        atomic_store_explicit(&temp->fully_linked, 1, memory_order_release);
+        Unlock_preds(preds, highest);
+        rv = 1;
+        break;
+    }
+    Epoch_exit();
+
+    return rv;
+}
+
+/*-------------------- Member Operation ----------------------- */
+static int Skip_member(int value){
+    skip_node_s *pred = head, *curr = NULL;
+    int rv;
+
+    Epoch_enter();
+    for (int level = MAX_LEVEL - 1; level >= 0; level--){
+        curr = Next(pred, level);
+        while (curr->data < value){
+            pred = curr;
+            curr = Next(pred, level);
+        }
+        if (curr->data == value)
+            break;
+    }
+    rv = curr->data == value && atomic_load_explicit(&curr->fully_linked, memory_order_acquire) &&
+         !atomic_load_explicit(&curr->marked, memory_order_acquire);
+    Epoch_exit();
+
+    return rv;
+}
+
+/*--------------------- Delete Node Operation --------------------- */
+/* If value is in list, return 1, else return 0 */
+static int Skip_delete(int value){
+    skip_node_s *preds[MAX_LEVEL], *succs[MAX_LEVEL];
+    skip_node_s *victim = NULL;
+    int is_marked = 0, top_level = -1;
+    int rv;
+
+    Epoch_enter();
+    for (;;){
+        int found = Find(value, preds, succs);
+        if (found != -1)
+            victim = succs[found];
+
+        if (!is_marked && (found == -1 || !atomic_load(&victim->fully_linked) ||
+                           victim->top_level != found || atomic_load(&victim->marked))){
+            rv = 0; /* Not in list (or not yet / no more) */
+            break;
+        }
+
+// 1. Logical delete: mark the victim, once
+        if (!is_marked){
+            top_level = victim->top_level;
+            pthread_mutex_lock(&victim->lock);
+            if (atomic_load(&victim->marked)){
+                pthread_mutex_unlock(&victim->lock);
+                rv = 0;
+                break;
+            }
+            atomic_store_explicit(&victim->marked, 1, memory_order_release);
+            is_marked = 1;
+        }
+
+// 2. Lock the predecessors and validate them
+        int highest = -1, valid = 1;
+        skip_node_s *prev = NULL;
+        for (int level = 0; valid && level <= top_level; level++){
+            skip_node_s *pred = preds[level];
+            if (pred != prev){
+                pthread_mutex_lock(&pred->lock);
+                prev = pred;
+            }
+            highest = level;
+            valid = !atomic_load(&pred->marked) && Next(pred, level) == victim;
+        }
+        if (!valid){
+            Unlock_preds(preds, highest);
+            continue;
+        }
+
+// 3. Physical delete, top-down
+        for (int level = top_level; level >= 0; level--)
+            atomic_store_explicit(&preds[level]->next[level], Next(victim, level), memory_order_release);
+        pthread_mutex_unlock(&victim->lock);
+        Unlock_preds(preds, highest);
+        Epoch_retire(victim, Free_node);
+        rv = 1;
+        break;
+    }
+    Epoch_exit();
+
+    return rv;
+}
+
+/*------------------ Count the Nodes --------------------*/
+static int Skip_size(void){
+    int i = 0;
+
+    Epoch_enter();
+    for (skip_node_s *curr = Next(head, 0); curr != tail; curr = Next(curr, 0))
+        if (atomic_load(&curr->fully_linked) && !atomic_load(&curr->marked))
+            i++;
+    Epoch_exit();
+    return i;
+}
+
+/*------------------ Free-List Operation --------------------*/
+/* No threads are running: frees the list and the retired nodes */
+static void Skip_free(void){
+    skip_node_s *curr = Next(head, 0), *following;
+
+    while (curr != tail){
+        following = Next(curr, 0);
+        Free_node(curr);
+        curr = following;
+    }
+    for (int level = 0; level < MAX_LEVEL; level++)
+        atomic_store(&head->next[level], tail);
+    Epoch_drain();
+}
+
+const list_impl_s list_impl = {
+    .name = "skip_list",
+    .concurrent = 1,
+    .insert = Skip_insert,
+    .member = Skip_member,
+    .delete = Skip_delete,
+    .size = Skip_size,
+    .free_list = Skip_free,
+};
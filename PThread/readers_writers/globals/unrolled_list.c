@@ -0,0 +1,268 @@
+/* Purpose:
+ *     An unrolled sorted list: every node holds up to UNROLL_KEYS sorted
+ *     ints in two cache lines, so a walk costs one cache miss per node
+ *     instead of one per key. Not thread-safe, like globals/list.c: the
+ *     gate of the policy protects it.
+ *
+ *     Member:  skips whole nodes by their first key, then searches the
+ *              keys of one node (SSE2: four keys per compare)
+ *     Insert:  shifts the keys of the node up; a full node is split in
+ *              two halves first
+ *     Delete:  shifts the keys down; a node that gets less than a
+ *              quarter full takes the keys of the next one if they fit
+ *     Bulk load:  fills the nodes to 3/4 in one pass
+ *     Range:   from the node of lo on, key by key
+ *
+ * Notes:
+ *     1. The walk only reads next and keys[0], both in the first cache
+ *        line of a node; the second line is read in the last node only.
+ *     2. The unused slots hold INT_MAX, so the search compares all the
+ *        slots without masking: the position of value is the number of
+ *        keys less than it.
+ *     3. Nodes are aligned to a cache line (aligned_alloc, or the pool
+ *        with POOL=1, whose slabs are aligned).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "helpers.h"
+
+#define CACHE_LINE 64
+#define UNROLL_KEYS 28                 // 2 cache lines: next, count, 28 keys
+#define UNROLL_MIN (UNROLL_KEYS / 4)   // fewer keys: merge with the next node
+
+typedef struct unrolled_node_tag{
+    struct unrolled_node_tag *next;
+    int count;
+    int keys[UNROLL_KEYS] __attribute__((aligned(16)));
+}__attribute__((aligned(CACHE_LINE))) unrolled_node_s;
+
+static unrolled_node_s *head = NULL;
+
+/* ------------------ Local Helpers ------------------ */
+static unrolled_node_s *New_node(void){
+#ifdef NODE_POOL
+    unrolled_node_s *node = NODE_ALLOC(sizeof(unrolled_node_s));
+#else
+    unrolled_node_s *node = aligned_alloc(CACHE_LINE, sizeof(unrolled_node_s));
+#endif
+    node->next = NULL;
+    node->count = 0;
+    for (int i = 0; i < UNROLL_KEYS; i++)
+        node->keys[i] = INT_MAX;
+    return node;
+}
+
+static void Free_node(unrolled_node_s *node){
+    NODE_FREE(node, sizeof(unrolled_node_s));
+}
+
+/* The number of keys of node less than value */
+static int Rank(const unrolled_node_s *node, int value){
+#ifdef __SSE2__
+    __m128i v = _mm_set1_epi32(value);
+    int less = 0;
+
+    for (int i = 0; i < UNROLL_KEYS; i += 4){
+        __m128i k = _mm_load_si128((const __m128i *)&node->keys[i]);
+        less += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(k, v))));
+    }
+    return less;
+#else
+    int i = 0;
+
+    while (i < node->count && node->keys[i] < value)
+        i++;
+    return i;
+#endif
+}
+
+/* The node where value is or belongs: the last one whose first key is
+ * <= value (or head). *pred_p gets the node before it. */
+static unrolled_node_s *Find(int value, unrolled_node_s **pred_p){
+    unrolled_node_s *pred = NULL, *curr = head;
+
+    while (curr->next != NULL && curr->next->keys[0] <= value){
+        pred = curr;
+        curr = curr->next;
+    }
+    if (pred_p != NULL)
+        *pred_p = pred;
+    return curr;
+}
+
+/*------------------- Insert Node Operation ------------------- */
+/* If value is not in list, return 1, else return 0 */
+static int Unrolled_insert(int value){
+    unrolled_node_s *curr, *half;
+    int pos;
+
+    if (head == NULL)
+        head = New_node();
+    curr = Find(value, NULL);
+    pos = Rank(curr, value);
+    if (pos < curr->count && curr->keys[pos] == value) /* value in list */
+        return 0;
+
+// A full node: move its upper half to a new node after it
+    if (curr->count == UNROLL_KEYS){
+        half = New_node();
+        half->count = UNROLL_KEYS / 2;
+        memcpy(half->keys, &curr->keys[UNROLL_KEYS / 2], half->count * sizeof(int));
+        for (int i = UNROLL_KEYS / 2; i < UNROLL_KEYS; i++)
+            curr->keys[i] = INT_MAX;
+        curr->count = UNROLL_KEYS / 2;
+        half->next = curr->next;
+        curr->next = half;
+        if (pos > curr->count){
+            pos -= curr->count;
+            curr = half;
+        }
+    }
+
+    memmove(&curr->keys[pos + 1], &curr->keys[pos], (curr->count - pos) * sizeof(int));
+    curr->keys[pos] = value;
+    curr->count++;
+    return 1;
+}
+
+/*-------------------- Member Operation ----------------------- */
+static int Unrolled_member(int value){
+    unrolled_node_s *curr;
+    int pos;
+
+    if (head == NULL)
+        return 0;
+    curr = Find(value, NULL);
+    pos = Rank(curr, value);
+    return pos < curr->count && curr->keys[pos] == value;
+}
+
+/*------------------ Batch of Lookups --------------------*/
+/* keys are sorted: the walk goes on from the node of the previous key */
+static void Unrolled_member_batch(const int *keys, int *found, int n){
+    unrolled_node_s *curr = head;
+
+    for (int i = 0; i < n; i++){
+        int pos;
+
+        if (curr == NULL){
+            found[i] = 0;
+            continue;
+        }
+        while (curr->next != NULL && curr->next->keys[0] <= keys[i])
+            curr = curr->next;
+        pos = Rank(curr, keys[i]);
+        found[i] = pos < curr->count && curr->keys[pos] == keys[i];
+    }
+}
+
+/*--------------------- Delete Node Operation --------------------- */
+/* If value is in list, return 1, else return 0 */
+static int Unrolled_delete(int value){
+    unrolled_node_s *pred, *curr, *following;
+    int pos;
+
+    if (head == NULL)
+        return 0;
+    curr = Find(value, &pred);
+    pos = Rank(curr, value);
+    if (pos == curr->count || curr->keys[pos] != value) /* Not in list */
+        return 0;
+
+    memmove(&curr->keys[pos], &curr->keys[pos + 1], (curr->count - pos - 1) * sizeof(int));
+    curr->keys[--curr->count] = INT_MAX;
+
+// Nearly empty: take the keys of the next node if they fit
+    following = curr->next;
+    if (curr->count < UNROLL_MIN && following != NULL && curr->count + following->count <= UNROLL_KEYS){
+        memcpy(&curr->keys[curr->count], following->keys, following->count * sizeof(int));
+        curr->count += following->count;
+        curr->next = following->next;
+        Free_node(following);
+    }
+    else if (curr->count == 0){
+        if (pred == NULL)
+            head = curr->next;
+        else
+            pred->next = curr->next;
+        Free_node(curr);
+    }
+    return 1;
+}
+
+/*------------------ Range Scan --------------------*/
+/* The caller holds the read gate, so the keys are a snapshot */
+static int Unrolled_range(int lo, int hi, int *keys, int max){
+    unrolled_node_s *curr;
+    int pos, n = 0;
+
+    if (head == NULL)
+        return 0;
+    curr = Find(lo, NULL);
+    for (pos = Rank(curr, lo); curr != NULL; curr = curr->next, pos = 0)
+        for (; pos < curr->count; pos++, n++){
+            if (curr->keys[pos] > hi)
+                return n;
+            if (n < max)
+                keys[n] = curr->keys[pos];
+        }
+    return n;
+}
+
+/*------------------ Bulk Load --------------------*/
+/* The list is empty, keys are sorted and distinct: fill the nodes to
+ * 3/4, so the first inserts do not split every node */
+static void Unrolled_bulk_load(const int *keys, int n){
+    unrolled_node_s **tail = &head;
+    int per_node = UNROLL_KEYS * 3 / 4;
+
+    for (int i = 0; i < n; i += per_node){
+        unrolled_node_s *node = New_node();
+        node->count = n - i < per_node ? n - i : per_node;
+        memcpy(node->keys, &keys[i], node->count * sizeof(int));
+        *tail = node;
+        tail = &node->next;
+    }
+}
+
+/*------------------ Count the Nodes --------------------*/
+/* The number of keys, as for the other lists */
+static int Unrolled_size(void){
+    int n = 0;
+
+    for (unrolled_node_s *curr = head; curr != NULL; curr = curr->next)
+        n += curr->count;
+    return n;
+}
+
+/*------------------ Free-List Operation --------------------*/
+static void Unrolled_free(void){
+    unrolled_node_s *curr = head, *following;
+
+    while (curr != NULL){
+        following = curr->next;
+        Free_node(curr);
+        curr = following;
+    }
+    head = NULL;
+}
+
+const list_impl_s list_impl = {
+    .name = "unrolled_list",
+    .concurrent = 0,
+    .insert = Unrolled_insert,
+    .member = Unrolled_member,
+    .delete = Unrolled_delete,
+    .size = Unrolled_size,
+    .free_list = Unrolled_free,
+    .member_batch = Unrolled_member_batch,
+    .bulk_load = Unrolled_bulk_load,
+    .range = Unrolled_range,
+};
@@ -0,0 +1,323 @@
+/* Purpose:
+ *     The operations the threads run, generated before the timer starts
+ *     (or read from a trace file), so producing keys and op types costs
+ *     nothing inside the timed region.
+ *
+ *     Workload_keys:     -D uniform | zipf[:theta] | hotspot[:fraction[:probability]]
+ *     Workload_mix:      -M p:k[,p:k...]  read / insert percentages per phase
+ *     Workload_ranges:   -R fraction[:width]  lookups that scan a range instead
+ *     Workload_generate: ops_per_thread ops for every thread
+ *     Workload_save:     -w file, writes the generated ops as a trace
+ *     Workload_load:     -r file, replays a trace instead of generating
+ *
+ * Notes:
+ *     1. zipf: key ranks follow a Zipf law (Gray et al., as in YCSB),
+ *        rank 0 the most frequent. The ranks are scattered over the key
+ *        space with a bijection, so the hot keys are not all at the head
+ *        of the sorted list.
+ *     2. hotspot: a fraction of the keys gets a probability of the ops.
+ *     3. Phases: the ops of every thread are split in equal consecutive
+ *        parts, phase i with its own read / insert percentages, e.g.
+ *        -M 0.99:0.005,0.5:0.25 is read-mostly first, then write-heavy.
+ *     4. Trace file: a trace_header_s (with the total of ops and the
+ *        width of the range scans), then the ops of thread 0, of
+ *        thread 1, ... as workload_op_s (native byte order).
+ *     5. A trace is replayed as recorded: records with an unknown op or
+ *        a key outside [0, MAX_KEY) are rejected, and -D / -M / -R do
+ *        not apply to it.
+ *     6. Range scans are taken out of the lookups, so p:k still splits
+ *        reads and writes; the keys of other ops do not change.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../../../helpers/my_rand.h"
+
+#include "helpers.h"
+
+#define MAX_PHASES 16
+#define TRACE_MAGIC "RWTRACE2"  // 2: range_width in the header
+#define SCATTER 2654435761ULL  // odd, not a multiple of 5: a bijection mod 10^k
+
+enum { KEYS_UNIFORM, KEYS_ZIPF, KEYS_HOTSPOT };
+
+typedef struct{
+    char magic[8];
+    int threads;
+    int ops_per_thread;
+    int total_ops;  // the first total_ops % threads threads run one op more
+    int range_width;
+}trace_header_s;
+
+typedef struct{
+    double search;
+    double insert;
+}phase_s;
+
+workload_op_s **workload = NULL;
+int ops_per_thread = 0;
+int range_width = 100;
+
+static int key_dist = KEYS_UNIFORM;
+static double zipf_theta = 0.99;
+static double hot_fraction = 0.01, hot_probability = 0.9;
+static phase_s phases[MAX_PHASES];
+static int phase_count = 0;  // 0: search_percent / insert_percent
+static double range_fraction = 0.0;
+static int replayed = 0;
+static int replayed_ranges = 0;  // the trace has OP_RANGE records
+static int workload_threads = 0;  // rows of workload
+
+/* Zipf constants */
+static double zeta_n, zeta_2, alpha, eta;
+
+/* ------------------ Local Helpers ------------------ */
+/* Uniform in [0, 1). (my_drand is in [-1, 1], made for the Monte Carlo) */
+static double Uniform(unsigned *seed){
+    return my_rand(seed) / 4294967291.0;
+}
+
+/* sum of 1/i^theta for i = 1..n: exact for the first terms, then the
+ * integral, which is accurate once the terms change slowly */
+static double Zeta(long n, double theta){
+    long exact = n < 10000 ? n : 10000;
+    double sum = 0.0;
+
+    for (long i = 1; i <= exact; i++)
+        sum += pow((double)i, -theta);
+    if (n > exact)
+        sum += (pow(n + 0.5, 1.0 - theta) - pow(exact + 0.5, 1.0 - theta)) / (1.0 - theta);
+    return sum;
+}
+
+static void Init_zipf(void){
+    zeta_n = Zeta(MAX_KEY, zipf_theta);
+    zeta_2 = Zeta(2, zipf_theta);
+    alpha = 1.0 / (1.0 - zipf_theta);
+    eta = (1.0 - pow(2.0 / MAX_KEY, 1.0 - zipf_theta)) / (1.0 - zeta_2 / zeta_n);
+}
+
+static long Zipf_rank(unsigned *seed){
+    double u = Uniform(seed), uz = u * zeta_n;
+    long rank;
+
+    if (uz < 1.0)
+        return 0;
+    if (uz < 1.0 + pow(0.5, zipf_theta))
+        return 1;
+    rank = (long)(MAX_KEY * pow(eta * u - eta + 1.0, alpha));
+    return rank < MAX_KEY ? rank : MAX_KEY - 1;
+}
+
+static int Next_key(unsigned *seed){
+    long hot_keys;
+
+    switch (key_dist){
+    case KEYS_ZIPF:
+        return (int)((Zipf_rank(seed) * SCATTER) % MAX_KEY);
+    case KEYS_HOTSPOT:
+        hot_keys = (long)(hot_fraction * MAX_KEY);
+        if (hot_keys < 1)
+            hot_keys = 1;
+        if (Uniform(seed) < hot_probability)
+            return (int)(((my_rand(seed) % hot_keys) * SCATTER) % MAX_KEY);
+        return (int)(((hot_keys + my_rand(seed) % (MAX_KEY - hot_keys)) * SCATTER) % MAX_KEY);
+    default:
+        return my_rand(seed) % MAX_KEY;
+    }
+}
+
+static void Alloc_workload(void){
+    workload_threads = thread_count;
+    workload = calloc(thread_count, sizeof(workload_op_s *));
+    for (int t = 0; workload != NULL && t < thread_count; t++)
+        if ((workload[t] = malloc((ops_per_thread + 1) * sizeof(workload_op_s))) == NULL){
+            Workload_free();
+            break;
+        }
+    if (workload == NULL){
+        perror("Workload");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/*------------------- Options ------------------- */
+/* Returns 0 if spec is not a key distribution */
+int Workload_keys(const char *spec){
+    if (strcmp(spec, "uniform") == 0)
+        key_dist = KEYS_UNIFORM;
+    else if (strncmp(spec, "zipf", 4) == 0){
+        key_dist = KEYS_ZIPF;
+        if (spec[4] == ':')
+            zipf_theta = strtod(spec + 5, NULL);
+        if (zipf_theta <= 0.0 || zipf_theta == 1.0)
+            return 0;
+    }
+    else if (strncmp(spec, "hotspot", 7) == 0){
+        key_dist = KEYS_HOTSPOT;
+        if (spec[7] == ':' && sscanf(spec + 8, "%lf:%lf", &hot_fraction, &hot_probability) < 1)
+            return 0;
+        if (hot_fraction <= 0.0 || hot_fraction >= 1.0 || hot_probability < 0.0 || hot_probability > 1.0)
+            return 0;
+    }
+    else
+        return 0;
+    return 1;
+}
+
+/* Returns 0 if spec is not a list of p:k phases */
+int Workload_mix(const char *spec){
+    const char *s = spec;
+    int used;
+
+    phase_count = 0;
+    while (*s != '\0'){
+        phase_s *ph = &phases[phase_count];
+        if (phase_count == MAX_PHASES || sscanf(s, "%lf:%lf%n", &ph->search, &ph->insert, &used) != 2)
+            return 0;
+        if (ph->search < 0.0 || ph->insert < 0.0 || ph->search + ph->insert > 1.0)
+            return 0;
+        phase_count++;
+        s += used;
+        if (*s == ',')
+            s++;
+    }
+    return phase_count > 0;
+}
+
+/* Returns 0 if spec is not fraction[:width] */
+int Workload_ranges(const char *spec){
+    if (sscanf(spec, "%lf:%d", &range_fraction, &range_width) < 1)
+        return 0;
+    return range_fraction > 0.0 && range_fraction <= 1.0 && range_width >= 1 && range_width <= MAX_KEY;
+}
+
+/* 1 if the threads will run range scans (generated or replayed) */
+int Workload_has_ranges(void){
+    return replayed ? replayed_ranges : range_fraction > 0.0;
+}
+
+/*------------------- Generate ------------------- */
+/* thread_count threads, ops_per_thread ops each. Thread t uses the
+ * same seed as before (t + 1), so runs stay repeatable. */
+void Workload_generate(void){
+    phase_s single = {search_percent, insert_percent};
+    phase_s *ph = phase_count > 0 ? phases : &single;
+    int count = phase_count > 0 ? phase_count : 1;
+
+    if (replayed)
+        return;
+    if (key_dist == KEYS_ZIPF)
+        Init_zipf();
+    Alloc_workload();
+    for (int t = 0; t < thread_count; t++){
+        unsigned seed = t + 1;
+        for (int i = 0; i < ops_per_thread; i++){
+            const phase_s *p = &ph[(long)i * count / ops_per_thread];
+            double which_op = Uniform(&seed);
+
+            workload[t][i].op = which_op < p->search ? OP_MEMBER :
+                                which_op < p->search + p->insert ? OP_INSERT : OP_DELETE;
+            if (workload[t][i].op == OP_MEMBER && range_fraction > 0.0 && Uniform(&seed) < range_fraction)
+                workload[t][i].op = OP_RANGE;
+            workload[t][i].key = Next_key(&seed);
+        }
+    }
+}
+
+/*------------------- Trace Files ------------------- */
+int Workload_save(const char *path){
+    trace_header_s header = {TRACE_MAGIC, thread_count, ops_per_thread, total_ops, range_width};
+    FILE *f = fopen(path, "wb");
+    int ok;
+
+    if (f == NULL){
+        perror(path);
+        return 0;
+    }
+    ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    for (int t = 0; ok && t < thread_count; t++)
+        ok = fwrite(workload[t], sizeof(workload_op_s), ops_per_thread, f) == (size_t)ops_per_thread;
+    if (fclose(f) != 0 || !ok){
+        fprintf(stderr, "%s: write failed\n", path);
+        return 0;
+    }
+    return 1;
+}
+
+/* 1 if every op of the thread is an operation on a key of the list.
+ * Notes the range scans in replayed_ranges. */
+static int Valid_ops(const workload_op_s *ops, int n){
+    for (int i = 0; i < n; i++){
+        if (ops[i].op < 0 || ops[i].op >= OP_TYPES || ops[i].key < 0 || ops[i].key >= MAX_KEY)
+            return 0;
+        if (ops[i].op == OP_RANGE)
+            replayed_ranges = 1;
+    }
+    return 1;
+}
+
+/* Sets thread_count, ops_per_thread, total_ops and range_width from the trace */
+int Workload_load(const char *path){
+    trace_header_s header;
+    FILE *f = fopen(path, "rb");
+    int ok;
+
+    if (f == NULL){
+        perror(path);
+        return 0;
+    }
+    ok = fread(&header, sizeof(header), 1, f) == 1 && memcmp(header.magic, TRACE_MAGIC, 8) == 0 &&
+         header.threads > 0 && header.threads <= MAX_THREADS && header.ops_per_thread >= 0 &&
+         header.total_ops > (long)header.threads * (header.ops_per_thread - 1) &&
+         header.total_ops <= (long)header.threads * header.ops_per_thread &&
+         header.range_width >= 1 && header.range_width <= MAX_KEY;
+    if (ok){
+        thread_count = header.threads;
+        ops_per_thread = header.ops_per_thread;
+        total_ops = header.total_ops;
+        range_width = header.range_width;
+        Alloc_workload();
+        for (int t = 0; ok && t < thread_count; t++)
+            ok = fread(workload[t], sizeof(workload_op_s), ops_per_thread, f) == (size_t)ops_per_thread &&
+                 Valid_ops(workload[t], ops_per_thread);
+    }
+    fclose(f);
+    if (!ok){
+        fprintf(stderr, "%s: not a readers_writers trace (or recorded with another MAX_KEY)\n", path);
+        return 0;
+    }
+    replayed = 1;
+    return 1;
+}
+
+/*------------------- Report / Cleanup ------------------- */
+void Workload_describe(void){
+    if (replayed)
+        printf("Workload: trace replay");
+    else if (key_dist == KEYS_ZIPF)
+        printf("Workload: zipf keys (theta %.2f)", zipf_theta);
+    else if (key_dist == KEYS_HOTSPOT)
+        printf("Workload: hotspot keys (%g of the keys get %g of the ops)", hot_fraction, hot_probability);
+    else
+        printf("Workload: uniform keys");
+    printf(", %d threads x %d ops", thread_count, ops_per_thread);
+    if (!replayed && phase_count > 1)
+        printf(", %d phases", phase_count);
+    if (replayed && replayed_ranges)
+        printf(", range scans of %d keys", range_width);
+    else if (!replayed && range_fraction > 0.0)
+        printf(", %g of the lookups scan %d keys", range_fraction, range_width);
+    printf("\n");
+}
+
+void Workload_free(void){
+    if (workload == NULL)
+        return;
+    for (int t = 0; t < workload_threads; t++)
+        free(workload[t]);
+    free(workload);
+    workload = NULL;
+}
@@ -0,0 +1,73 @@
+#!/bin/bash
+set -euo pipefail #-e:exit on error | -u:treat unset variables as an error | -o pipefail treat unset variables as an error
+IFS=$'\n\t' #This defines how Bash splits words when expanding variables, reading files, etc.
+
+# ==============================================================================
+# BENCHMARK SCRIPT: COST OF THE READER-WRITER LOCKS FROM 1 TO 64 THREADS
+# The list is empty and stays almost empty (1% inserts, 1% deletes), so the
+# time per operation is mostly the cost of entering and leaving the lock.
+# ==============================================================================
+
+# --- Configuration (Global Constants) ---
+readonly POLICIES=("priorityR.c" "priorityW.c" "scalable_rw.c" "phase_fair.c" "futex_rw.c" "cohort.c")
+readonly SRC_MAIN="main.c"
+readonly SRC_LIST="globals/list.c"
+readonly SRC_RAND="../../helpers/my_rand.c"
+readonly SRC_TOPO="../../helpers/topology.c"
+readonly SRC_GLOBALS="globals/globals.c globals/helpers.c globals/epoch.c globals/node_pool.c globals/histogram.c globals/workload.c globals/bloom.c globals/bulk_load.c"
+readonly EXEC="./lock_bench"
+readonly THREADS=(1 2 4 8 16 32 64)
+readonly RUNS_PER_THREAD=3
+
+# Input validation
+if [ $# -lt 1 ] || [ $# -gt 2 ]; then
+    echo "Usage: $0 <operations> [read_percentage]" >&2
+    exit 1
+fi
+readonly OPS=$1
+readonly READS=${2:-0.98}
+readonly INSERTS=$(awk "BEGIN {print (1 - $READS) / 2}")
+
+declare -A RESULTS # "policy threads" -> ns per operation
+
+for policy in "${POLICIES[@]}"; do
+    name=$(basename "$policy" .c)
+    echo "======================================================"
+    echo " --> Compiling $policy"
+    echo "======================================================"
+    # $SRC_GLOBALS is split on purpose: IFS does not contain spaces
+    IFS=' ' read -r -a globals <<< "$SRC_GLOBALS"
+    if ! gcc -O2 -o "$EXEC" "$SRC_MAIN" "$policy" "$SRC_LIST" "${globals[@]}" "$SRC_RAND" "$SRC_TOPO" -lpthread -lm; then
+        echo "--> Compilation of $policy FAILED. Skipping." >&2
+        continue
+    fi
+
+    for t in "${THREADS[@]}"; do
+        best=""
+        for ((j=1; j<=RUNS_PER_THREAD; j++)); do
+            elapsed=$("$EXEC" 0 "$OPS" "$READS" "$INSERTS" "$t" | awk '/Elapsed time/ {print $4}')
+            if [ -z "$best" ] || awk "BEGIN {exit !($elapsed < $best)}"; then
+                best=$elapsed
+            fi
+        done
+        # Every thread does OPS/t operations: cost seen by one thread per operation
+        RESULTS["$name $t"]=$(awk "BEGIN {printf \"%.1f\", $best * 1e9 * $t / $OPS}")
+        echo "  $t threads: ${RESULTS["$name $t"]} ns per operation"
+    done
+done
+
+echo "======================================================"
+echo "--> ns per operation and thread (best of $RUNS_PER_THREAD, $READS reads)"
+printf "%-14s" "threads"
+for t in "${THREADS[@]}"; do printf "%9s" "$t"; done
+echo ""
+for policy in "${POLICIES[@]}"; do
+    name=$(basename "$policy" .c)
+    printf "%-14s" "$name"
+    for t in "${THREADS[@]}"; do printf "%9s" "${RESULTS["$name $t"]:--}"; done
+    echo ""
+done
+echo "======================================================"
+
+# --- Cleanup ---
+[[ -f $EXEC ]] && rm "$EXEC"
@@ -1,16 +1,46 @@
-/*Purpose:  
+/*Purpose:
  *   Implement a multi-threaded sorted linked list of
  *   ints with ops insert, print, member, delete, free list.
  *   Read-write locks are implemented to avoid race-conditions.
  * Compile:
  *   Makefile:
- *       make build P_SRC=priority_file.c
+ *       make build P_SRC=priority_file.c [LIST_SRC=globals/list_file.c] [POOL=1]
+ *   P_SRC is the reader-writer policy (priorityR.c, priorityW.c,
+ *   scalable_rw.c, phase_fair.c, flat_combining.c, futex_rw.c, cohort.c,
+ *   no_lock.c)
+ *   and LIST_SRC the list (globals/list.c by default, globals/lf_list.c,
+ *   globals/hoh_list.c, globals/skip_list.c, globals/rcu_list.c,
+ *   globals/sharded_list.c, globals/unrolled_list.c).
+ *   POOL=1 allocates the nodes from per-thread pools (globals/node_pool.c)
+ *   instead of malloc/free.
  * Usage:
  *   make run m=<m> n=<operations> p=<read_percentage> k=<insert_percentage> t=<num_of_threads>
  *   e.g make run m=1000 n=150000 p=0.95 k=0.03 t=2
+ *   Options after the arguments (make run ... opts="-H"):
+ *       -H  latency and gate-wait histograms (p50/p99/p99.9/max) per operation
+ *       -P  contention profile: wait, hold, handoffs and futile wakeups
+ *           per operation type and per thread
+ *       -D uniform|zipf[:theta]|hotspot[:fraction[:probability]]  the keys
+ *       -M p:k[,p:k...]  phases with their own read / insert percentages
+ *       -w file / -r file  record / replay the operations as a binary trace
+ *       -s shards  key-range shards of globals/sharded_list.c
+ *       -d secs  run for a fixed time instead of n ops, report ops/sec
+ *       -S  scaling curve: 1, 2, 4, ... t threads, -d secs each
+ *       -b n  consecutive lookups in sorted batches of up to n, one gate each
+ *       -F keys  Bloom filter (globals/bloom.c) sized for `keys` keys
+ *       -R f[:w]  a fraction f of the lookups scan the keys [key, key + w)
+ *   The operations are generated before the timer starts (globals/workload.c).
+ *   The m initial keys are sorted and linked in one pass (globals/bulk_load.c).
+ *   The concurrent lists run without a gate:
+ *       make build P_SRC=no_lock.c LIST_SRC=globals/lf_list.c
+ *       make build P_SRC=no_lock.c LIST_SRC=globals/hoh_list.c [CFLAGS="-Wall -DHOH_COUPLING"]
+ *       make build P_SRC=no_lock.c LIST_SRC=globals/skip_list.c
+ *       make build P_SRC=no_lock.c LIST_SRC=globals/rcu_list.c
+ *       make build P_SRC=no_lock.c LIST_SRC=globals/sharded_list.c
  * Aggregate Results:
  *   Use results.sh script to run the source code for both
- *   priority approaches and compare the results.
+ *   priority approaches and compare the results, and lock_scaling.sh
+ *   for the cost of the gates alone from 1 to 64 threads.
  *   Usage:
  *     chmod +x results.sh
  *     ./results.sh <m> <operations> <read_percentage> <insert_percentage>
@@ -19,42 +49,515 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdatomic.h>
 #include <pthread.h>
-#include "../../helpers/my_rand.h"
 #include "../../helpers/timer.h"
 
 #include "globals/helpers.h"
 
+#define CACHE_LINE 64
+
+static double duration = 0.0;        // -d: seconds, 0 runs total_ops
+static _Atomic int stop_flag = 0;
+static long done_ops[MAX_THREADS];  // per thread, of the last run
+static int member_batch = 1;        // -b: consecutive lookups per gate
+static long bloom_keys = 0;         // -F: keys the Bloom filter is sized for
+static long filtered_total = 0;     // lookups the filter answered, last run
+static __thread long my_filtered = 0;
+static long range_count = 0;        // -R: range scans of the last run
+static long range_keys = 0;         // and the keys they returned
+static const char *op_names[OP_TYPES] = {"member", "insert", "delete", "range"};
+
+/* -P: where the time of every thread goes, per operation type */
+typedef struct{
+    long ops;
+    unsigned long wait_ns;   // entering the gate
+    unsigned long hold_ns;   // inside the gate: the list operation
+    unsigned long total_ns;  // the whole operation, leaving included
+    long handoffs;           // the gate came from another thread
+    long wakeups;            // blocking waits of the policy that returned
+    long futile;             // ... and had to wait again
+}contention_s;
+
+typedef struct{
+    contention_s op[OP_TYPES];
+}__attribute__((aligned(CACHE_LINE))) thread_contention_s;
+
+static int profile = 0;
+static thread_contention_s contention[MAX_THREADS];  // of the last run
+static _Atomic long last_writer = -1;
+static _Atomic long writes_done = 0;
+static __thread long my_writes_seen = 0;
+
+/*---------------------------- Contention Profile ---------------------------- */
+/* Did the gate come from another thread? For a writer: the last writer
+ * was another thread. For a reader: another thread wrote since its
+ * last read. Called inside the gate. The writes of a write_op policy
+ * never pass here: Print_contention shows n/a. */
+static int Handoff(int writing){
+    long seen;
+
+    if (writing){
+        my_writes_seen = atomic_fetch_add_explicit(&writes_done, 1, memory_order_relaxed) + 1;
+        seen = atomic_exchange_explicit(&last_writer, thread_rank, memory_order_relaxed);
+        return seen >= 0 && seen != thread_rank;
+    }
+    seen = atomic_load_explicit(&writes_done, memory_order_relaxed);
+    if (seen == my_writes_seen)
+        return 0;
+    my_writes_seen = seen;
+    return 1;
+}
+
+/* Adds n operations to the profile of the thread. entered == 0: the
+ * policy ran the operation itself (write_op), only the total is known.
+ * A lock that waited w times got w - 1 futile wakeups. */
+static void Profile_ops(int op, int n, unsigned long start, unsigned long entered,
+                        unsigned long left, int handoff, long woken){
+    contention_s *c = &contention[thread_rank].op[op];
+    long w = gate_wakeups - woken;
+
+    c->ops += n;
+    c->total_ns += Hist_now() - start;
+    if (entered != 0){
+        c->wait_ns += entered - start;
+        c->hold_ns += left - entered;
+    }
+    c->handoffs += handoff;
+    c->wakeups += w;
+    c->futile += w > 1 ? w - 1 : 0;
+}
+
+/*---------------------------- Timed Operation ---------------------------- */
+/* One operation through the gate. With -H it records how long it took
+ * and how long it waited for the gate in the thread's own histograms,
+ * with -P it adds the times to the thread's contention profile. */
+static int Do_op(int op, int val, histogram_s (*my_hist)[HIST_KINDS]){
+    unsigned long start = 0, entered = 0, left = 0;
+    int timed = my_hist != NULL || profile, handoff = 0;
+    long woken = gate_wakeups;
+    int rv;
+
+    if (timed)
+        start = Hist_now();
+    if (op == OP_MEMBER && use_bloom && !Bloom_maybe(val)){
+        rv = 0; // surely not in the list: no gate, no walk
+        my_filtered++;
+    }
+    else if (op == OP_MEMBER){
+        rw_policy.read_lock();
+        if (timed)
+            entered = Hist_now();
+        if (profile)
+            handoff = Handoff(0);
+        rv = Member(val);
+        if (timed)
+            left = Hist_now();
+        rw_policy.read_unlock();
+    }
+    else if (op == OP_RANGE){ // returns the number of keys in the range
+        rw_policy.read_lock();
+        if (timed)
+            entered = Hist_now();
+        if (profile)
+            handoff = Handoff(0);
+        rv = Range(val, val + range_width - 1, NULL, 0);
+        if (timed)
+            left = Hist_now();
+        rw_policy.read_unlock();
+    }
+    else if (rw_policy.write_op != NULL) // the policy applies it (flat combining)
+        rv = rw_policy.write_op(op, val);
+    else{
+        rw_policy.write_lock();
+        if (timed)
+            entered = Hist_now();
+        if (profile)
+            handoff = Handoff(1);
+        rv = op == OP_INSERT ? Insert(val) : Delete(val);
+        if (timed)
+            left = Hist_now();
+        rw_policy.write_unlock();
+    }
+    if (profile)
+        Profile_ops(op, 1, start, entered, left, handoff, woken);
+
+    if (my_hist != NULL){
+        Hist_record(&my_hist[op][HIST_LATENCY], Hist_now() - start);
+        if (entered != 0) // write_op: the wait is not separate from the work
+            Hist_record(&my_hist[op][HIST_LOCK_WAIT], entered - start);
+    }
+    return rv;
+}
+
+/* Lookups of n keys under one read acquisition (Member_batch). Every
+ * key is recorded with the time of the whole batch. With -F the keys
+ * the filter rules out never reach the gate. */
+static void Do_member_batch(const int *keys, int n, histogram_s (*my_hist)[HIST_KINDS]){
+    unsigned long start = 0, entered = 0, left = 0, end;
+    int found[MAX_BATCH], maybe[MAX_BATCH];
+    int m = n, handoff = 0;
+    long woken = gate_wakeups;
+
+    if (my_hist != NULL || profile)
+        start = Hist_now();
+    if (use_bloom){
+        m = 0;
+        for (int i = 0; i < n; i++)
+            if (Bloom_maybe(keys[i]))
+                maybe[m++] = keys[i];
+        my_filtered += n - m;
+        keys = maybe;
+    }
+    entered = start;
+    if (m > 0){
+        rw_policy.read_lock();
+        if (my_hist != NULL || profile)
+            entered = Hist_now();
+        if (profile)
+            handoff = Handoff(0);
+        Member_batch(keys, found, m);
+        if (profile)
+            left = Hist_now();
+        rw_policy.read_unlock();
+    }
+    if (profile)
+        Profile_ops(OP_MEMBER, n, start, entered, m > 0 ? left : start, handoff, woken);
+
+    if (my_hist != NULL){
+        end = Hist_now();
+        for (int i = 0; i < n; i++){
+            Hist_record(&my_hist[OP_MEMBER][HIST_LATENCY], end - start);
+            Hist_record(&my_hist[OP_MEMBER][HIST_LOCK_WAIT], entered - start);
+        }
+    }
+}
+
+/*---------------------------- Thread Task ---------------------------- */
+/* Every thread runs its share of total_ops pre-generated operations
+ * (workload.c) through the reader-writer policy (rw_policy) on the
+ * list (list_impl); with -d it cycles through them until stop_flag. */
+void *Thread_task(void *rank){
+    long my_rank = (long)rank;
+    int i, next = 0;
+    const workload_op_s *my_ops = workload[my_rank];
+    int my_count = total_ops / thread_count + (my_rank < total_ops % thread_count);
+    int my_member_count = 0, my_insert_count = 0, my_delete_count = 0;
+    int my_not_insert = 0, my_not_deleted = 0;
+    long my_range_count = 0, my_range_keys = 0;
+    histogram_s (*my_hist)[HIST_KINDS] = NULL;
+    int keys[MAX_BATCH], n;
+
+    thread_rank = my_rank;
+    my_filtered = 0;
+    if (record_latency && (my_hist = calloc(OP_TYPES, sizeof(*my_hist))) == NULL){
+        perror("Thread_task");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; duration > 0 ? !atomic_load_explicit(&stop_flag, memory_order_relaxed) : i < my_count; i++){
+        int op = my_ops[next].op, val = my_ops[next].key;
+
+        if (++next == ops_per_thread)
+            next = 0;
+        switch (op){
+        case OP_MEMBER:
+            if (member_batch == 1){
+                Do_op(OP_MEMBER, val, my_hist);
+                my_member_count++;
+                break;
+            }
+// -b: take the lookups that follow too, up to member_batch of them
+            keys[0] = val;
+            for (n = 1; n < member_batch && (duration > 0 || i + n < my_count) &&
+                        my_ops[next].op == OP_MEMBER; n++){
+                keys[n] = my_ops[next].key;
+                if (++next == ops_per_thread)
+                    next = 0;
+            }
+            Do_member_batch(keys, n, my_hist);
+            my_member_count += n;
+            i += n - 1;
+            break;
+        case OP_RANGE:
+            my_range_keys += Do_op(OP_RANGE, val, my_hist);
+            my_range_count++;
+            break;
+        case OP_INSERT: // insert or delete: a writing operation
+            my_not_insert += !Do_op(OP_INSERT, val, my_hist);
+            my_insert_count++;
+            break;
+        default:
+            my_not_deleted += !Do_op(OP_DELETE, val, my_hist);
+            my_delete_count++;
+        }
+    }
+
+    pthread_mutex_lock(&count_mutex);
+    if (my_hist != NULL)
+        for (int op = 0; op < OP_TYPES; op++)
+            for (int kind = 0; kind < HIST_KINDS; kind++)
+                Hist_merge(&op_hist[op][kind], &my_hist[op][kind]);
+    member_count += my_member_count;
+    insert_count += my_insert_count;
+    delete_count += my_delete_count;
+    not_insert += my_not_insert;
+    not_deleted += my_not_deleted;
+    filtered_total += my_filtered;
+    range_count += my_range_count;
+    range_keys += my_range_keys;
+    pthread_mutex_unlock(&count_mutex);
+    done_ops[my_rank] = i;
+    free(my_hist);
+
+    return NULL;
+}
+
+/*---------------------------- Fill the List ---------------------------- */
+/* Try to insert inserts_in_main keys, but give up after
+ * 2*inserts_in_main attempts. Same keys on every call: they are sorted
+ * (by thread_count threads) and linked in one pass, see bulk_load.c */
+static long Fill_list(int inserts_in_main){
+    return Bulk_fill(inserts_in_main, thread_count);
+}
+
+/*---------------------------- Run the Threads ---------------------------- */
+/* Starts threads threads on the list and returns the elapsed seconds:
+ * until the last one finishes its ops, or after `duration` seconds. */
+static double Run_threads(int threads){
+    pthread_t *thread_handles = malloc(threads * sizeof(pthread_t));
+    struct timespec wait;
+    double start, finish;
+    long i;
+
+    thread_count = threads;
+    member_count = insert_count = delete_count = not_insert = not_deleted = 0;
+    filtered_total = 0;
+    range_count = range_keys = 0;
+    memset(contention, 0, sizeof(contention));
+    atomic_store(&last_writer, -1);
+    atomic_store(&writes_done, 0);
+    memset(op_hist, 0, sizeof(op_hist));
+    atomic_store(&stop_flag, 0);
+
+    GET_TIME(start);
+    for (i = 0; i < threads; i++)
+        pthread_create(&thread_handles[i], NULL, Thread_task, (void *)i);
+    if (duration > 0){
+        wait.tv_sec = (time_t)duration;
+        wait.tv_nsec = (long)((duration - wait.tv_sec) * 1e9);
+        while (nanosleep(&wait, &wait) != 0)
+            ;
+        atomic_store(&stop_flag, 1);
+    }
+
+    for (i = 0; i < threads; i++)
+        pthread_join(thread_handles[i], NULL);
+    GET_TIME(finish);
+    free(thread_handles);
+
+    return finish - start;
+}
+
+/*---------------------------- Latency Report ---------------------------- */
+static void Print_latency(void){
+    int types = range_count > 0 ? OP_TYPES : OP_RANGE;  // no range line without -R
+    char label[32];
+
+    printf("Latency per operation (gate + list):\n");
+    for (int op = 0; op < types; op++)
+        Hist_print(op_names[op], &op_hist[op][HIST_LATENCY]);
+    printf("Waiting for the gate:\n");
+    for (int op = 0; op < types; op++){
+        snprintf(label, sizeof(label), "%s wait", op_names[op]);
+        Hist_print(label, &op_hist[op][HIST_LOCK_WAIT]);
+    }
+}
+
+/* -P: per operation type, then per thread, over the last run */
+static void Print_contention(int threads){
+    contention_s sum;
+
+    printf("Contention profile (ms; futile: woken up only to wait again):\n");
+    printf("%-10s %10s %10s %10s %10s %10s %10s %10s\n", "", "ops", "wait", "hold", "total",
+           "handoffs", "wakeups", "futile");
+    for (int op = 0; op < OP_TYPES + threads; op++){
+        char handoffs[24] = "n/a";  // write_op: the writes are not seen one by one
+
+        memset(&sum, 0, sizeof(sum));
+        for (int t = 0; t < threads; t++)
+            for (int o = 0; o < OP_TYPES; o++){
+                const contention_s *c = &contention[t].op[o];
+                if (op < OP_TYPES ? o != op : t != op - OP_TYPES)
+                    continue;
+                sum.ops += c->ops;
+                sum.wait_ns += c->wait_ns;
+                sum.hold_ns += c->hold_ns;
+                sum.total_ns += c->total_ns;
+                sum.handoffs += c->handoffs;
+                sum.wakeups += c->wakeups;
+                sum.futile += c->futile;
+            }
+        if (op < OP_TYPES && sum.ops == 0)
+            continue;
+        if (rw_policy.write_op == NULL)
+            snprintf(handoffs, sizeof(handoffs), "%ld", sum.handoffs);
+        if (op < OP_TYPES)
+            printf("%-10s", op_names[op]);
+        else
+            printf("thread %-3d", op - OP_TYPES);
+        printf(" %10ld %10.1f %10.1f %10.1f %10s %10ld %10ld\n", sum.ops, sum.wait_ns / 1e6,
+               sum.hold_ns / 1e6, sum.total_ns / 1e6, handoffs, sum.wakeups, sum.futile);
+    }
+}
+
 /*---------------------------- Main Function ---------------------------- */
 int main(int argc, char *argv[])
 {
-    long i;
-    int key, success, attempts;
-    pthread_t *thread_handles;
-    int inserts_in_main;
-    unsigned seed = 1;
-    double start, finish;
+    long i, done = 0;
+    int inserts_in_main, max_threads;
+    int sweep = 0, shaped = 0;
+    double elapsed;
     char *ptr; // for strtod
-    if (argc != 6) usage(argv[0]);
-    
+    int opt;
+    const char *trace_out = NULL, *trace_in = NULL;
+    if (argc < 6) usage(argv[0]);
+
     inserts_in_main = atoi(argv[1]);
     total_ops = atoi(argv[2]);
     search_percent = strtod(argv[3], &ptr);
     insert_percent = strtod(argv[4], &ptr);
     thread_count = strtol(argv[5], NULL, 10);
 
-    /* Try to insert inserts_in_main keys, but give up after */
-    /* 2*inserts_in_main attempts.                           */
-    i = attempts = 0;
-    while (i < inserts_in_main && attempts < 2 * inserts_in_main)
-    {
-        key = my_rand(&seed) % MAX_KEY;
-        success = Insert(key);
-        attempts++;
-        if (success)
-            i++;
-    }
-    printf("Inserted %ld keys in empty list\n", i);
+// Options after the positional arguments
+    optind = 6;
+    while ((opt = getopt(argc, argv, "HPD:M:w:r:s:d:Sb:F:R:")) != -1){
+        switch (opt){
+        case 'H':
+            record_latency = 1;
+            break;
+        case 'P':
+            profile = 1;
+            break;
+        case 'D':
+            if (!Workload_keys(optarg)){
+                fprintf(stderr, "Unknown key distribution %s\n", optarg);
+                usage(argv[0]);
+            }
+            shaped = 1;
+            break;
+        case 'M':
+            if (!Workload_mix(optarg)){
+                fprintf(stderr, "Bad mix %s (p:k[,p:k...], p + k <= 1)\n", optarg);
+                usage(argv[0]);
+            }
+            shaped = 1;
+            break;
+        case 'R':
+            if (!Workload_ranges(optarg)){
+                fprintf(stderr, "Bad range scans %s (fraction[:width], 0 < fraction <= 1)\n", optarg);
+                usage(argv[0]);
+            }
+            shaped = 1;
+            break;
+        case 'w':
+            trace_out = optarg;
+            break;
+        case 'r':
+            trace_in = optarg;
+            break;
+        case 's':
+            shard_count = strtol(optarg, NULL, 10);
+            if (shard_count < 1){
+                fprintf(stderr, "The number of shards should be at least 1\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'd':
+            duration = strtod(optarg, NULL);
+            if (duration <= 0){
+                fprintf(stderr, "The duration should be more than 0 seconds\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'S':
+            sweep = 1;
+            break;
+        case 'F':
+            bloom_keys = strtol(optarg, NULL, 10);
+            if (bloom_keys < 1){
+                fprintf(stderr, "The Bloom filter needs a number of keys\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'b':
+            member_batch = strtol(optarg, NULL, 10);
+            if (member_batch < 1 || member_batch > MAX_BATCH){
+                fprintf(stderr, "The lookup batch should be between 1 and %d\n", MAX_BATCH);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        default:
+            usage(argv[0]);
+        }
+    }
+    if (trace_in != NULL && shaped){
+        fprintf(stderr, "-D, -M and -R shape generated operations: a trace (-r) is replayed as recorded\n");
+        exit(EXIT_FAILURE);
+    }
+    if (trace_in != NULL && !Workload_load(trace_in))
+        exit(EXIT_FAILURE);
+    if (sweep && duration == 0)
+        duration = 1.0;
+
+    if (thread_count <= 0 || thread_count > MAX_THREADS){
+        fprintf(stderr, "The number of threads should be between 1 and %d\n", MAX_THREADS);
+        exit(EXIT_FAILURE);
+    }
+    if (!rw_policy.gated && !list_impl.concurrent){
+        fprintf(stderr, "The %s policy has no gate, but %s is not thread-safe. "
+                "Use a concurrent list (e.g. LIST_SRC=globals/lf_list.c)\n",
+                rw_policy.name, list_impl.name);
+        exit(EXIT_FAILURE);
+    }
+    if (Workload_has_ranges() && list_impl.range == NULL){
+        fprintf(stderr, "%s has no range scans. Use globals/list.c, "
+                "globals/unrolled_list.c or globals/rcu_list.c\n", list_impl.name);
+        exit(EXIT_FAILURE);
+    }
+#ifdef NODE_POOL
+    printf("Policy: %s, list: %s, nodes: pool\n", rw_policy.name, list_impl.name);
+#else
+    printf("Policy: %s, list: %s, nodes: malloc\n", rw_policy.name, list_impl.name);
+#endif
+
+    if (list_impl.init != NULL)
+        list_impl.init();
+    if (bloom_keys > 0){
+        if (!Bloom_init(bloom_keys)){
+            perror("Bloom filter");
+            exit(EXIT_FAILURE);
+        }
+        use_bloom = 1;
+    }
+    printf("Inserted %ld keys in empty list\n", Fill_list(inserts_in_main));
+
+// Generate the operations before the timer starts: the first
+// total_ops % thread_count threads run one op more than the others
+// (a trace brings its own total_ops)
+    if (trace_in == NULL){
+        ops_per_thread = (total_ops + thread_count - 1) / thread_count;
+        Workload_generate();
+    }
+    if (duration > 0 && ops_per_thread == 0){
+        fprintf(stderr, "A timed run needs at least one operation per thread\n");
+        exit(EXIT_FAILURE);
+    }
+    if (trace_out != NULL && !Workload_save(trace_out))
+        exit(EXIT_FAILURE);
+    Workload_describe();
     // Print();
 
 #ifdef OUTPUT
@@ -63,22 +566,66 @@ int main(int argc, char *argv[])
     printf("\n");
 #endif
 
-    thread_handles = malloc(thread_count * sizeof(pthread_t));
     pthread_mutex_init(&count_mutex, NULL);
+    init_read_write_threads(&shared_resources);
+    max_threads = thread_count;
 
-    GET_TIME(start);
-    for (i = 0; i < thread_count; i++)
-        pthread_create(&thread_handles[i], NULL, Thread_task, (void *)i);
+// -S: the scaling curve, 1, 2, 4, ... max_threads threads for `duration`
+// seconds each, every run on a freshly filled list
+    if (sweep){
+        printf("Scaling curve, %g seconds per run:\n", duration);
+        printf("%8s %14s %14s %14s %14s\n", "threads", "ops/sec", "per thread", "slowest", "fastest");
+        for (int t = 1; ; t = t * 2 < max_threads ? t * 2 : max_threads){
+            long slowest = -1, fastest = 0;
+
+            if (t > 1){
+                Free_list();
+                Fill_list(inserts_in_main);
+            }
+            elapsed = Run_threads(t);
+            for (done = 0, i = 0; i < t; i++){
+                done += done_ops[i];
+                if (slowest < 0 || done_ops[i] < slowest)
+                    slowest = done_ops[i];
+                if (done_ops[i] > fastest)
+                    fastest = done_ops[i];
+            }
+            printf("%8d %14.0f %14.0f %14.0f %14.0f\n", t, done / elapsed, done / elapsed / t,
+                   slowest / elapsed, fastest / elapsed);
+            if (t == max_threads)
+                break;
+        }
+    }
+    else
+        elapsed = Run_threads(thread_count);
 
-    for (i = 0; i < thread_count; i++)
-        pthread_join(thread_handles[i], NULL);
-    GET_TIME(finish);
     Print();
-    printf("Elapsed time = %e seconds\n", finish - start);
+    printf("Elapsed time = %e seconds\n", elapsed);
+    if (duration > 0){
+        for (done = 0, i = 0; i < thread_count; i++)
+            done += done_ops[i];
+        total_ops = done;
+    }
     printf("Total ops = %d\n", total_ops);
     printf("member ops = %d\n", member_count);
     printf("insert ops = %d\n", insert_count);
     printf("delete ops = %d\n", delete_count);
+    if (duration > 0 && !sweep){
+        printf("Throughput = %.0f ops/sec (%.0f per thread)\n", done / elapsed, done / elapsed / thread_count);
+        for (i = 0; i < thread_count; i++)
+            printf("  thread %ld: %.0f ops/sec\n", i, done_ops[i] / elapsed);
+    }
+    if (range_count > 0)
+        printf("Range scans: %ld of %d lookups, %.1f keys each\n", range_count, member_count + (int)range_count,
+               (double)range_keys / range_count);
+    if (use_bloom)
+        printf("Bloom filter: %ld of %d lookups answered without the list\n", filtered_total, member_count);
+    if (record_latency)
+        Print_latency();
+    if (profile)
+        Print_contention(thread_count);
+    if (rw_policy.report != NULL)
+        rw_policy.report();
 
 #ifdef OUTPUT
     printf("After threads terminate, list = \n");
@@ -87,9 +634,11 @@ int main(int argc, char *argv[])
 #endif
 
     Free_list();
+    Node_pool_destroy();
+    Workload_free();
+    Bloom_destroy();
     pthread_mutex_destroy(&count_mutex);
     destroy_read_write_threads(&shared_resources);
-    free(thread_handles);
 
     return 0;
-} 
\ No newline at end of file
+}
@@ -0,0 +1,23 @@
+/* Purpose:
+ *   No reader-writer gate at all: readers and writers go straight to
+ *   the list, which must synchronize itself (globals/lf_list.c).
+ *   main.c refuses to run it with a list that is not concurrent.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "globals/helpers.h"
+
+static void No_lock(void){
+}
+
+const rw_policy_s rw_policy = {
+    .name = "no_lock",
+    .gated = 0,
+    .read_lock = No_lock,
+    .read_unlock = No_lock,
+    .write_lock = No_lock,
+    .write_unlock = No_lock,
+};
@@ -0,0 +1,98 @@
+/* Purpose:
+ *   A phase-fair reader-writer lock (the PF-T ticket lock of
+ *   Brandenburg and Anderson): read phases and write phases take turns,
+ *   so neither readers nor writers can starve.
+ *
+ *   Writer:  takes a ticket and waits for its turn among the writers
+ *            (one writer at a time, in arrival order). Then it marks
+ *            itself present in `rin`, which closes the read phase, and
+ *            waits until the readers that came before it have left.
+ *   Reader:  increments `rin`. If no writer is present it is in; else
+ *            it waits only until that one writer is done, even if more
+ *            writers are waiting.
+ *
+ * Notes:
+ *   1. rin / rout count the readers that came in / left, in steps of
+ *      RINC; the low bits of rin hold the writer present bit (PRES) and
+ *      the phase of that writer (PHID, the low bit of its ticket), so a
+ *      reader sees that "its" writer left even if the next writer is
+ *      already present.
+ *   2. Bounded waiting: a reader waits at most for one write phase and
+ *      a writer for one read phase plus the writers ahead of it.
+ *   3. Waiting spins a little, then yields the cpu (sched_yield), so
+ *      the lock still works with more threads than cores.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#include "globals/helpers.h"
+
+#define CACHE_LINE 64
+#define SPIN_LIMIT 100
+
+#define RINC  0x100u  // one reader in rin / rout
+#define WBITS 0x3u    // writer bits of rin
+#define PRES  0x2u    // a writer is present
+#define PHID  0x1u    // phase id of that writer
+
+/* Readers and writers update different counters: keep them apart */
+static _Atomic unsigned rin __attribute__((aligned(CACHE_LINE))) = 0;
+static _Atomic unsigned rout __attribute__((aligned(CACHE_LINE))) = 0;
+static _Atomic unsigned win __attribute__((aligned(CACHE_LINE))) = 0;
+static _Atomic unsigned wout __attribute__((aligned(CACHE_LINE))) = 0;
+
+/* ------------------ Local Helpers ------------------ */
+static inline void Backoff(int *spins){
+    if (++*spins > SPIN_LIMIT)
+        sched_yield();
+}
+
+/* ------------------ Reader Enters / Leaves ------------------ */
+static void Read_lock(void){
+    unsigned w = atomic_fetch_add_explicit(&rin, RINC, memory_order_acquire) & WBITS;
+    int spins = 0;
+
+// A writer is present: wait until it leaves (its bits change)
+    if (w != 0)
+        while ((atomic_load_explicit(&rin, memory_order_acquire) & WBITS) == w)
+            Backoff(&spins);
+}
+
+static void Read_unlock(void){
+    atomic_fetch_add_explicit(&rout, RINC, memory_order_release);
+}
+
+/* ------------------ Writer Enters / Leaves ------------------ */
+static void Write_lock(void){
+    unsigned ticket = atomic_fetch_add_explicit(&win, 1, memory_order_relaxed);
+    unsigned readers;
+    int spins = 0;
+
+// 1. Wait for the writers ahead of us
+    while (atomic_load_explicit(&wout, memory_order_acquire) != ticket)
+        Backoff(&spins);
+
+// 2. Close the read phase, then wait for the readers already in
+    readers = atomic_fetch_add_explicit(&rin, PRES | (ticket & PHID), memory_order_acq_rel);
+    spins = 0;
+    while (atomic_load_explicit(&rout, memory_order_acquire) != readers)
+        Backoff(&spins);
+}
+
+static void Write_unlock(void){
+// Open the next read phase, then let the next writer in
+    atomic_fetch_and_explicit(&rin, ~WBITS, memory_order_release);
+    atomic_fetch_add_explicit(&wout, 1, memory_order_release);
+}
+
+const rw_policy_s rw_policy = {
+    .name = "phase_fair",
+    .gated = 1,
+    .read_lock = Read_lock,
+    .read_unlock = Read_unlock,
+    .write_lock = Write_lock,
+    .write_unlock = Write_unlock,
+};
@@ -9,10 +9,23 @@ IFS=$'\n\t' #This defines how Bash splits words when expanding variables, readin
 
 # Global Configuration Constants (UPPERCASE)
 readonly SRC_MAIN="main.c"
-readonly SRC_PRIORITY=("priorityR.c" "priorityW.c")
+# Configurations to compare: "<policy source>:<list source>[:<extra flags>]"
+readonly CONFIGS=("priorityR.c:globals/list.c" "priorityW.c:globals/list.c" "scalable_rw.c:globals/list.c"
+                  "phase_fair.c:globals/list.c" "flat_combining.c:globals/list.c" "futex_rw.c:globals/list.c"
+                  "cohort.c:globals/list.c"
+                  "priorityW.c:globals/list.c:-DNODE_POOL" "priorityW.c:globals/unrolled_list.c"
+                  "no_lock.c:globals/lf_list.c" "no_lock.c:globals/hoh_list.c" "no_lock.c:globals/skip_list.c"
+                  "no_lock.c:globals/rcu_list.c" "no_lock.c:globals/sharded_list.c")
 readonly SRC_RAND="../../helpers/my_rand.c"
+readonly SRC_TOPO="../../helpers/topology.c"
 readonly SRC_GLOBALS="globals/globals.c"
 readonly SRC_HELPERS="globals/helpers.c"
+readonly SRC_EPOCH="globals/epoch.c"
+readonly SRC_POOL="globals/node_pool.c"
+readonly SRC_HIST="globals/histogram.c"
+readonly SRC_WORKLOAD="globals/workload.c"
+readonly SRC_BLOOM="globals/bloom.c"
+readonly SRC_BULK="globals/bulk_load.c"
 readonly EXEC="./executable"
 
 readonly THREADS_START=2
@@ -28,31 +41,34 @@ declare -A PROGRAM_TIMES    # Global array store thread averages per program
 compile_program() {
     # Local variable for function argument (lowercase)
     local priority_src="$1"
+    local list_src="$2"
+    local flags="$3"
     
-    # Using global constants
-    gcc -o "$EXEC" "$SRC_MAIN" "$priority_src" "$SRC_RAND" "$SRC_GLOBALS" "$SRC_HELPERS" -lpthread
+    # Using global constants ($flags unquoted: it may be empty)
+    gcc $flags -o "$EXEC" "$SRC_MAIN" "$priority_src" "$list_src" "$SRC_RAND" "$SRC_TOPO" "$SRC_GLOBALS" "$SRC_HELPERS" "$SRC_EPOCH" "$SRC_POOL" "$SRC_HIST" "$SRC_WORKLOAD" "$SRC_BLOOM" "$SRC_BULK" -lpthread -lm
 }
 
 # ==============================================================================
 # Benchmark Function
-# Arguments: $1 = priority source file, $2..$5 = program parameters
+# Arguments: $1 = "<policy source>:<list source>", $2..$5 = program parameters
 # ==============================================================================
 run_benchmark() {
     # Local variables for function arguments (lowercase)
-    local src="$1"
+    local src list_src flags
+    IFS=':' read -r src list_src flags <<< "$1"
     local a="$2"
     local b="$3"
     local c="$4"
     local pth="$5"
 
     local name
-    name=$(basename "$src" .c)
+    name="$(basename "$src" .c)+$(basename "$list_src" .c)${flags:+ $flags}"
 
     echo "======================================================"
-    echo " -->  Compiling $src"
+    echo " -->  Compiling $src with $list_src $flags"
     echo "======================================================"
 
-    if ! compile_program "$src"; then
+    if ! compile_program "$src" "$list_src" "$flags"; then
         echo "Compilation failed for $src — skipping."
         return 1
     fi
@@ -112,16 +128,15 @@ run_benchmark() {
 # ==============================================================================
 
 if [ $# -ne 4 ]; then
-    echo "Usage: $0 <rowsA> <columnsA_rowsB> <columnsB> <numOfPth>"
+    echo "Usage: $0 <keys_in_main> <operations> <read_percentage> <insert_percentage>"
     exit 1
 fi
 
-echo "Running priorityR..."
-run_benchmark "${SRC_PRIORITY[0]}" "$1" "$2" "$3" "$4"
-
-echo ""
-echo "Running priorityW..."
-run_benchmark "${SRC_PRIORITY[1]}" "$1" "$2" "$3" "$4"
+for config in "${CONFIGS[@]}"; do
+    echo "Running $config..."
+    run_benchmark "$config" "$1" "$2" "$3" "$4"
+    echo ""
+done
 
 [[ -f $EXEC ]] && rm "$EXEC"
 
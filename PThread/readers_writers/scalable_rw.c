@@ -0,0 +1,92 @@
+/* Purpose:
+ *   A scalable reader-writer lock: every reader announces itself in
+ *   its own cache line (a slot per thread, indexed by thread_rank)
+ *   instead of incrementing the shared `reading` counter under
+ *   data_mtx, so readers never write a line that other readers read.
+ *
+ *   Reader:  sets its slot, then checks the writer flag. If a writer
+ *            is there it clears its slot again and waits.
+ *   Writer:  takes the writer mutex (one writer at a time), sets the
+ *            writer flag and waits until every reader slot is clear.
+ *
+ * Notes:
+ *   1. Both sides store, fence, then load what the other side stored
+ *      (Dekker style), so a reader and a writer never both get in.
+ *   2. Writers have priority: a waiting writer sends new readers back.
+ *   3. Waiting spins a little, then yields the cpu (sched_yield), so
+ *      the lock still works with more threads than cores.
+ *   4. A write costs a pass over thread_count slots; reads cost one
+ *      store and a fence on a line no other thread touches.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "globals/helpers.h"
+
+#define CACHE_LINE 64
+#define SPIN_LIMIT 100
+
+typedef struct{
+    _Atomic int active;
+}__attribute__((aligned(CACHE_LINE))) reader_slot_s;
+
+static reader_slot_s readers[MAX_THREADS];
+static _Atomic int writer __attribute__((aligned(CACHE_LINE))) = 0;
+static pthread_mutex_t writer_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+/* ------------------ Local Helpers ------------------ */
+static void Wait_until_clear(_Atomic int *flag){
+    int spins = 0;
+
+    while (atomic_load_explicit(flag, memory_order_acquire)){
+        if (++spins > SPIN_LIMIT)
+            sched_yield();
+    }
+}
+
+/* ------------------ Reader Enters / Leaves ------------------ */
+static void Read_lock(void){
+    _Atomic int *mine = &readers[thread_rank].active;
+
+    for (;;){
+        atomic_store_explicit(mine, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (!atomic_load_explicit(&writer, memory_order_relaxed))
+            break;
+// A writer is in or waiting: step back and let it go first
+        atomic_store_explicit(mine, 0, memory_order_release);
+        Wait_until_clear(&writer);
+    }
+    atomic_thread_fence(memory_order_acquire);
+}
+
+static void Read_unlock(void){
+    atomic_store_explicit(&readers[thread_rank].active, 0, memory_order_release);
+}
+
+/* ------------------ Writer Enters / Leaves ------------------ */
+static void Write_lock(void){
+    pthread_mutex_lock(&writer_mtx);
+    atomic_store_explicit(&writer, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    for (int i = 0; i < thread_count; i++)
+        Wait_until_clear(&readers[i].active);
+}
+
+static void Write_unlock(void){
+    atomic_store_explicit(&writer, 0, memory_order_release);
+    pthread_mutex_unlock(&writer_mtx);
+}
+
+const rw_policy_s rw_policy = {
+    .name = "scalable_rw",
+    .gated = 1,
+    .read_lock = Read_lock,
+    .read_unlock = Read_unlock,
+    .write_lock = Write_lock,
+    .write_unlock = Write_unlock,
+};
@@ -0,0 +1,205 @@
+/* File:     mtx_alloc.c
+ *
+ * Purpose:  Allocate the large matrices and vectors of the programs
+ *
+ * mtx_alloc:        returns a block aligned to MTX_ALIGN bytes (huge
+ *                   blocks are aligned to MTX_HUGE_PAGE)
+ * mtx_free:         frees a block returned by mtx_alloc
+ * mtx_alloc_report: prints how much memory is in use and the peak
+ *
+ * Notes:
+ * 1.  Blocks smaller than MTX_HUGE_PAGE come from posix_memalign.
+ * 2.  Larger blocks are mapped with mmap and aligned to a huge page,
+ *     so the kernel can back them with transparent huge pages
+ *     (MADV_HUGEPAGE): fewer TLB misses on GB-sized matrices.
+ * 3.  The MTX_HUGEPAGES environment variable picks the backing of the
+ *     large blocks:
+ *         thp      madvise(MADV_HUGEPAGE) (default)
+ *         hugetlb  MAP_HUGETLB from the reserved hugetlbfs pool, falls
+ *                  back to thp when the pool is empty
+ *         off      plain 4K pages
+ * 4.  Nothing is written into a mapped block, so its pages are still
+ *     placed by the first thread that touches them (first-touch). The
+ *     sizes of the mapped blocks are kept in a small list instead.
+ * 5.  The functions are thread-safe.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "mtx_alloc.h"
+
+/* Backing of the huge blocks */
+enum { BACKING_OFF, BACKING_THP, BACKING_HUGETLB };
+
+/* A mapped block, kept so that mtx_free knows its size */
+typedef struct mapping_tag{
+    void *ptr;
+    size_t bytes;   // asked
+    size_t mapped;  // rounded up to huge pages
+    int hugetlb;
+    struct mapping_tag *next;
+}mapping_s;
+
+/* Small blocks keep their size in front of them */
+typedef struct{
+    size_t bytes;
+}small_header;
+
+static pthread_mutex_t alloc_mtx = PTHREAD_MUTEX_INITIALIZER;
+static mapping_s *mappings = NULL;
+static size_t in_use = 0, peak = 0;
+static long blocks = 0, huge_blocks = 0, hugetlb_blocks = 0;
+
+/* ------------------ Local Helpers ------------------ */
+static int backing(void){
+    const char *mode = getenv("MTX_HUGEPAGES");
+
+    if (mode == NULL || strcmp(mode, "thp") == 0)
+        return BACKING_THP;
+    if (strcmp(mode, "hugetlb") == 0)
+        return BACKING_HUGETLB;
+    return BACKING_OFF;
+}
+
+static void account(long bytes){
+    pthread_mutex_lock(&alloc_mtx);
+    in_use += bytes;
+    if (in_use > peak)
+        peak = in_use;
+    pthread_mutex_unlock(&alloc_mtx);
+}
+
+/* Maps `mapped` bytes aligned to MTX_HUGE_PAGE: maps one huge page
+ * more than needed and unmaps the unaligned head and tail. */
+static void *map_aligned(size_t mapped){
+    size_t len = mapped + MTX_HUGE_PAGE;
+    char *raw = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    char *aligned;
+
+    if (raw == MAP_FAILED)
+        return NULL;
+    aligned = (char *)(((size_t)raw + MTX_HUGE_PAGE - 1) & ~(MTX_HUGE_PAGE - 1));
+    if (aligned > raw)
+        munmap(raw, aligned - raw);
+    if (raw + len > aligned + mapped)
+        munmap(aligned + mapped, raw + len - (aligned + mapped));
+    return aligned;
+}
+
+static void *map_huge(size_t bytes){
+    size_t mapped = (bytes + MTX_HUGE_PAGE - 1) & ~(MTX_HUGE_PAGE - 1);
+    int mode = backing();
+    int hugetlb = 0;
+    void *ptr = NULL;
+    mapping_s *record;
+
+    if (mode == BACKING_HUGETLB){
+        ptr = mmap(NULL, mapped, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr == MAP_FAILED)
+            ptr = NULL;  // no reserved huge pages, fall back to THP
+        else
+            hugetlb = 1;
+    }
+    if (ptr == NULL){
+        ptr = map_aligned(mapped);
+        if (ptr == NULL)
+            return NULL;
+#ifdef MADV_HUGEPAGE
+        if (mode != BACKING_OFF)
+            madvise(ptr, mapped, MADV_HUGEPAGE);
+#endif
+    }
+
+    record = malloc(sizeof(mapping_s));
+    if (record == NULL){
+        munmap(ptr, mapped);
+        return NULL;
+    }
+    record->ptr = ptr;
+    record->bytes = bytes;
+    record->mapped = mapped;
+    record->hugetlb = hugetlb;
+
+    pthread_mutex_lock(&alloc_mtx);
+    record->next = mappings;
+    mappings = record;
+    blocks++;
+    if (mode != BACKING_OFF)
+        huge_blocks++;
+    hugetlb_blocks += hugetlb;
+    pthread_mutex_unlock(&alloc_mtx);
+
+    account(bytes);
+    return ptr;
+}
+
+/* Function:      mtx_alloc
+ * In arg:        bytes
+ * Return value:  A block of at least bytes bytes aligned to MTX_ALIGN,
+ *                or NULL (like malloc) when there is no memory
+ */
+void *mtx_alloc(size_t bytes){
+    small_header *header;
+
+    if (bytes >= MTX_HUGE_PAGE)
+        return map_huge(bytes);
+
+// The header takes a whole cache line, so the data stays aligned
+    if (posix_memalign((void **)&header, MTX_ALIGN, bytes + MTX_ALIGN) != 0)
+        return NULL;
+    header->bytes = bytes;
+
+    pthread_mutex_lock(&alloc_mtx);
+    blocks++;
+    pthread_mutex_unlock(&alloc_mtx);
+    account(bytes);
+
+    return (char *)header + MTX_ALIGN;
+}
+
+/* Function:      mtx_free
+ * In arg:        ptr, a block from mtx_alloc or NULL
+ */
+void mtx_free(void *ptr){
+    mapping_s **link, *record = NULL;
+    small_header *header;
+
+    if (ptr == NULL)
+        return;
+
+    pthread_mutex_lock(&alloc_mtx);
+    for (link = &mappings; *link != NULL; link = &(*link)->next)
+        if ((*link)->ptr == ptr){
+            record = *link;
+            *link = record->next;
+            break;
+        }
+    pthread_mutex_unlock(&alloc_mtx);
+
+    if (record != NULL){
+        munmap(record->ptr, record->mapped);
+        account(-(long)record->bytes);
+        free(record);
+        return;
+    }
+
+    header = (small_header *)((char *)ptr - MTX_ALIGN);
+    account(-(long)header->bytes);
+    free(header);
+}
+
+/* Function:      mtx_alloc_report
+ * Purpose:       Print the memory in use, the peak and how many blocks
+ *                were backed by huge pages
+ */
+void mtx_alloc_report(void){
+    pthread_mutex_lock(&alloc_mtx);
+    printf("Matrix memory: peak %.2f MB, in use %.2f MB, %ld blocks (%ld huge-page, %ld hugetlbfs)\n",
+           peak / (1024.0 * 1024.0), in_use / (1024.0 * 1024.0),
+           blocks, huge_blocks, hugetlb_blocks);
+    pthread_mutex_unlock(&alloc_mtx);
+}
@@ -0,0 +1,20 @@
+/* File:     mtx_alloc.h
+ * Purpose:  Header file for mtx_alloc.c, the allocator for the large
+ *           matrices and vectors of the programs: aligned blocks,
+ *           huge-page backing and size accounting.
+ */
+#ifndef _MTX_ALLOC_H_
+#define _MTX_ALLOC_H_
+
+#include <stddef.h>
+
+/* Every block is aligned at least to a cache line */
+#define MTX_ALIGN 64
+/* Blocks of this size or larger are mapped on huge pages */
+#define MTX_HUGE_PAGE (2UL * 1024 * 1024)
+
+void *mtx_alloc(size_t bytes);
+void mtx_free(void *ptr);
+void mtx_alloc_report(void);
+
+#endif
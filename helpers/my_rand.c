@@ -4,6 +4,7 @@
  *
  * my_rand:  generates a random unsigned int in the range 0 - MR_MODULUS
  * my_drand: generates a random double in the range 0 - 1
+ * my_seed:  generates a starting seed for an independent stream
  *
  * Notes:
  * 1.  The generator is taken from the Wikipedia article "Linear congruential
@@ -56,3 +57,22 @@ double my_drand(unsigned *seed_p){
     y = y - 1.0;                       // then i sub 1.0 so the number will fall i the ragne of [-1 , 1]
     return y;
 }
+
+/* Function:      my_seed
+ * In arg:        stream
+ * Return value:  A seed in the range 1 - MR_MODULUS-1 for the stream'th
+ *                sequence of my_rand
+ *
+ * Notes:
+ * 1.  Consecutive seeds (rank + 1) give correlated sequences with this
+ *     generator, so the stream number is scrambled first.
+ * 2.  A zero seed would make my_rand return 0 forever, so it is never
+ *     returned.
+ */
+unsigned my_seed(unsigned stream){
+    unsigned z = stream + 0x9E3779B9U;
+    z = (z ^ (z >> 16)) * 0x85EBCA6BU;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35U;
+    z ^= z >> 16;
+    return z % (MR_MODULUS - 1) + 1;
+}
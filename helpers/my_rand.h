@@ -10,5 +10,6 @@
 
 unsigned my_rand(unsigned *a_p);
 double my_drand(unsigned *a_p);
+unsigned my_seed(unsigned stream);
 
 #endif
@@ -0,0 +1,210 @@
+/* File:     topology.c
+ *
+ * Purpose:  Read the cache geometry and the cpu topology from sysfs
+ *
+ * topo_line_size:  the coherency line size of the L1 data cache
+ * topo_caches:     the caches of a cpu (level, type, line, size, sharing)
+ * topo_cpus:       the online cpus with their core and package
+ * topo_pick_pair:  two cpus on the same core, socket or on two sockets
+ * topo_print:      prints all the above
+ *
+ * Notes:
+ * 1.  Everything comes from /sys/devices/system/cpu. When it is missing
+ *     (containers, other systems) the line size falls back to sysconf
+ *     and then to 64 bytes, and every cpu is its own core on package 0.
+ * 2.  core_id is only unique inside a package, so two cpus are on the
+ *     same core when both their package and their core match.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "topology.h"
+
+#define SYSFS_CPU "/sys/devices/system/cpu"
+#define DEFAULT_LINE_SIZE 64
+
+/* ------------------ Local Helpers ------------------ */
+/* Reads the first line of a sysfs file, returns 0 if it is missing */
+static int read_line(const char *path, char *buf, int len){
+    FILE *fp = fopen(path, "r");
+
+    if (!fp)
+        return 0;
+    if (!fgets(buf, len, fp)){
+        fclose(fp);
+        return 0;
+    }
+    fclose(fp);
+    buf[strcspn(buf, "\n")] = '\0';
+    return 1;
+}
+
+static long read_long(const char *path, long fallback){
+    char buf[64];
+    return read_line(path, buf, sizeof(buf)) ? strtol(buf, NULL, 10) : fallback;
+}
+
+/* Sizes are written as "48K" or "32M" */
+static long parse_size(const char *text){
+    char *end;
+    long size = strtol(text, &end, 10);
+
+    if (*end == 'K')
+        size *= 1024;
+    else if (*end == 'M')
+        size *= 1024 * 1024;
+    return size;
+}
+
+static int cpu_online(int cpu){
+    char path[128];
+
+    snprintf(path, sizeof(path), SYSFS_CPU "/cpu%d/online", cpu);
+// cpu0 usually has no "online" file: it cannot be taken offline
+    return read_long(path, 1) == 1;
+}
+
+/* Function:      topo_line_size
+ * Return value:  The cache line size in bytes
+ */
+int topo_line_size(void){
+    topo_cache caches[TOPO_MAX_CACHES];
+    int count = topo_caches(0, caches, TOPO_MAX_CACHES);
+
+    for (int i = 0; i < count; i++)
+        if (caches[i].level == 1 && strcmp(caches[i].type, "Instruction") != 0 &&
+            caches[i].line_size > 0)
+            return caches[i].line_size;
+#ifdef _SC_LEVEL1_DCACHE_LINESIZE
+    long line = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+    if (line > 0)
+        return (int)line;
+#endif
+    return DEFAULT_LINE_SIZE;
+}
+
+/* Function:      topo_caches
+ * In args:       cpu, max
+ * Out arg:       caches
+ * Return value:  The number of caches found
+ */
+int topo_caches(int cpu, topo_cache caches[], int max){
+    char path[128], buf[64];
+    int count = 0;
+
+    for (int index = 0; count < max; index++){
+        snprintf(path, sizeof(path), SYSFS_CPU "/cpu%d/cache/index%d/level", cpu, index);
+        if (!read_line(path, buf, sizeof(buf)))
+            break;
+        topo_cache *c = &caches[count++];
+        c->level = atoi(buf);
+
+        snprintf(path, sizeof(path), SYSFS_CPU "/cpu%d/cache/index%d/type", cpu, index);
+        if (!read_line(path, c->type, sizeof(c->type)))
+            strcpy(c->type, "Unknown");
+        snprintf(path, sizeof(path), SYSFS_CPU "/cpu%d/cache/index%d/coherency_line_size", cpu, index);
+        c->line_size = (int)read_long(path, 0);
+        snprintf(path, sizeof(path), SYSFS_CPU "/cpu%d/cache/index%d/size", cpu, index);
+        c->size = read_line(path, buf, sizeof(buf)) ? parse_size(buf) : 0;
+        snprintf(path, sizeof(path), SYSFS_CPU "/cpu%d/cache/index%d/shared_cpu_list", cpu, index);
+        if (!read_line(path, c->shared_cpus, sizeof(c->shared_cpus)))
+            strcpy(c->shared_cpus, "?");
+    }
+    return count;
+}
+
+/* Function:      topo_cpus
+ * In arg:        max
+ * Out arg:       cpus
+ * Return value:  The number of online cpus
+ */
+int topo_cpus(topo_cpu cpus[], int max){
+    long configured = sysconf(_SC_NPROCESSORS_CONF);
+    char path[128];
+    int count = 0;
+
+    for (int cpu = 0; cpu < configured && count < max; cpu++){
+        if (!cpu_online(cpu))
+            continue;
+        cpus[count].cpu = cpu;
+        snprintf(path, sizeof(path), SYSFS_CPU "/cpu%d/topology/core_id", cpu);
+        cpus[count].core = (int)read_long(path, cpu);
+        snprintf(path, sizeof(path), SYSFS_CPU "/cpu%d/topology/physical_package_id", cpu);
+        cpus[count].package = (int)read_long(path, 0);
+        count++;
+    }
+    return count;
+}
+
+/* Function:      topo_pick_pair
+ * In args:       cpus, ncpus, placement
+ * Out args:      a, b: the two cpus, -1 for TOPO_ANY (not pinned)
+ * Return value:  1 if the machine has such a pair, 0 otherwise
+ */
+int topo_pick_pair(const topo_cpu cpus[], int ncpus, int placement, int *a, int *b){
+    *a = *b = -1;
+    if (placement == TOPO_ANY)
+        return 1;
+
+    for (int i = 0; i < ncpus; i++)
+        for (int j = i + 1; j < ncpus; j++){
+            int same_package = cpus[i].package == cpus[j].package;
+            int same_core = same_package && cpus[i].core == cpus[j].core;
+
+            if ((placement == TOPO_SMT && same_core) ||
+                (placement == TOPO_SOCKET && same_package && !same_core) ||
+                (placement == TOPO_CROSS && !same_package)){
+                *a = cpus[i].cpu;
+                *b = cpus[j].cpu;
+                return 1;
+            }
+        }
+    return 0;
+}
+
+/* Function:      topo_placement_name
+ * Return value:  A short name for the placement of a pair of threads
+ */
+const char *topo_placement_name(int placement){
+    switch (placement){
+        case TOPO_SMT:    return "smt";
+        case TOPO_SOCKET: return "socket";
+        case TOPO_CROSS:  return "cross";
+        default:          return "any";
+    }
+}
+
+/* Function:      topo_print
+ * Purpose:       Print the caches of cpu 0 and the cores and packages
+ */
+void topo_print(void){
+    topo_cache caches[TOPO_MAX_CACHES];
+    topo_cpu *cpus = malloc(TOPO_MAX_CPUS * sizeof(topo_cpu));
+    int ncaches = topo_caches(0, caches, TOPO_MAX_CACHES);
+    int ncpus = topo_cpus(cpus, TOPO_MAX_CPUS);
+    int packages = 0, cores = 0;
+
+    printf("Cache line size: %d bytes\n", topo_line_size());
+    for (int i = 0; i < ncaches; i++)
+        printf("  L%d %-11s %8ld KB, %3d-byte lines, shared by cpus %s\n",
+               caches[i].level, caches[i].type, caches[i].size / 1024,
+               caches[i].line_size, caches[i].shared_cpus);
+
+// Count the distinct packages and (package, core) pairs
+    for (int i = 0; i < ncpus; i++){
+        int new_package = 1, new_core = 1;
+        for (int j = 0; j < i; j++){
+            if (cpus[j].package == cpus[i].package){
+                new_package = 0;
+                if (cpus[j].core == cpus[i].core)
+                    new_core = 0;
+            }
+        }
+        packages += new_package;
+        cores += new_core;
+    }
+    printf("Online cpus: %d, cores: %d, packages: %d\n", ncpus, cores, packages);
+    free(cpus);
+}
@@ -0,0 +1,37 @@
+/* File:     topology.h
+ * Purpose:  Header file for topology.c, which reads the cache geometry
+ *           and the cpu topology of the machine from sysfs.
+ */
+#ifndef _TOPOLOGY_H_
+#define _TOPOLOGY_H_
+
+#define TOPO_MAX_CPUS 1024
+#define TOPO_MAX_CACHES 8
+
+/* One cache of a cpu (/sys/devices/system/cpu/cpuN/cache/indexK) */
+typedef struct{
+    int level;
+    char type[16];        // Data, Instruction or Unified
+    int line_size;        // bytes
+    long size;            // bytes
+    char shared_cpus[64]; // cpus sharing this cache, e.g. "0-3"
+}topo_cache;
+
+/* Where a cpu sits (/sys/devices/system/cpu/cpuN/topology) */
+typedef struct{
+    int cpu;
+    int core;
+    int package;
+}topo_cpu;
+
+/* Placements of a pair of threads */
+enum { TOPO_ANY, TOPO_SMT, TOPO_SOCKET, TOPO_CROSS, TOPO_PLACEMENTS };
+
+int topo_line_size(void);
+int topo_caches(int cpu, topo_cache caches[], int max);
+int topo_cpus(topo_cpu cpus[], int max);
+int topo_pick_pair(const topo_cpu cpus[], int ncpus, int placement, int *a, int *b);
+const char *topo_placement_name(int placement);
+void topo_print(void);
+
+#endif
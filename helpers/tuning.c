@@ -0,0 +1,193 @@
+/* File:     tuning.c
+ *
+ * Purpose:  A persistent cache of tuned configurations
+ *
+ * tune_class:  names the size class of a problem
+ * tune_set:    sets a parameter of a configuration
+ * tune_get:    reads a parameter of a configuration
+ * tune_load:   looks up the winner for (program, machine, size class)
+ * tune_store:  records the winner for (program, machine, size class)
+ *
+ * Notes:
+ * 1.  The cache is a text file, "tuning.cache" in the working directory
+ *     unless the TUNING_FILE environment variable names another one.
+ *     Every line is
+ *         <program> <machine> <size class> <seconds> <name>=<value> ...
+ *     and lines starting with '#' are ignored. Delete a line (or the
+ *     file) to make the program search again.
+ * 2.  The machine is the host name and the number of online cpus, so
+ *     one file can be shared between machines.
+ * 3.  Sizes are grouped by powers of two: 1000x1000 and 1500x1200 have
+ *     the same class ("9x9" and "10x10" differ).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include "tuning.h"
+
+#define TUNE_LINE_LEN 512
+#define TUNE_MACHINE_LEN 128
+
+/* ------------------ Local Helpers ------------------ */
+static const char *tuning_file(void){
+    const char *file = getenv("TUNING_FILE");
+    return file ? file : "tuning.cache";
+}
+
+static void machine_id(char *machine){
+    char host[64] = "unknown";
+
+    gethostname(host, sizeof(host) - 1);
+    host[sizeof(host) - 1] = '\0';
+    snprintf(machine, TUNE_MACHINE_LEN, "%s/%dcpu", host, tune_max_threads());
+}
+
+/* Function:      tune_max_threads
+ * Return value:  The number of online cpus, the upper end of the
+ *                thread counts worth searching
+ */
+int tune_max_threads(void){
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (int)cpus : 1;
+}
+
+/* Function:      tune_class
+ * In args:       dims, ndims
+ * Out arg:       size_class, e.g. "12x12x7" for 4096 x 5000 x 200
+ */
+void tune_class(char *size_class, const long dims[], int ndims){
+    int len = 0;
+
+    size_class[0] = '\0';
+    for (int i = 0; i < ndims && len < TUNE_CLASS_LEN; i++)
+        len += snprintf(size_class + len, TUNE_CLASS_LEN - len, "%s%d",
+                        i ? "x" : "", dims[i] > 0 ? (int)log2((double)dims[i]) : 0);
+}
+
+/* Function:      tune_set
+ * In args:       name, value
+ * In/out arg:    cfg
+ */
+void tune_set(tune_config *cfg, const char *name, long value){
+    for (int i = 0; i < cfg->count; i++)
+        if (strcmp(cfg->name[i], name) == 0){
+            cfg->value[i] = value;
+            return;
+        }
+    if (cfg->count == TUNE_MAX_PARAMS)
+        return;
+    snprintf(cfg->name[cfg->count], TUNE_NAME_LEN, "%s", name);
+    cfg->value[cfg->count++] = value;
+}
+
+/* Function:      tune_get
+ * Return value:  The value of name in cfg, or fallback if it is missing
+ */
+long tune_get(const tune_config *cfg, const char *name, long fallback){
+    for (int i = 0; i < cfg->count; i++)
+        if (strcmp(cfg->name[i], name) == 0)
+            return cfg->value[i];
+    return fallback;
+}
+
+/* Function:      tune_load
+ * In args:       program, size_class
+ * Out arg:       cfg
+ * Return value:  1 if the cache has a configuration for this program,
+ *                machine and size class, 0 otherwise
+ */
+int tune_load(const char *program, const char *size_class, tune_config *cfg){
+    char line[TUNE_LINE_LEN], machine[TUNE_MACHINE_LEN];
+    char l_program[64], l_machine[TUNE_MACHINE_LEN], l_class[TUNE_CLASS_LEN];
+    double seconds;
+    int offset, found = 0;
+    FILE *fp = fopen(tuning_file(), "r");
+
+    if (!fp)
+        return 0;
+    machine_id(machine);
+    while (!found && fgets(line, sizeof(line), fp)){
+        if (line[0] == '#')
+            continue;
+        if (sscanf(line, "%63s %127s %63s %lf %n", l_program, l_machine,
+                   l_class, &seconds, &offset) != 4)
+            continue;
+        if (strcmp(l_program, program) || strcmp(l_machine, machine) ||
+            strcmp(l_class, size_class))
+            continue;
+
+        cfg->count = 0;
+        for (char *tok = strtok(line + offset, " \t\n"); tok; tok = strtok(NULL, " \t\n")){
+            char *eq = strchr(tok, '=');
+            if (!eq)
+                continue;
+            *eq = '\0';
+            tune_set(cfg, tok, strtol(eq + 1, NULL, 10));
+        }
+        found = 1;
+    }
+    fclose(fp);
+    return found;
+}
+
+/* Function:      tune_store
+ * In args:       program, size_class, cfg, seconds
+ *
+ * Notes:
+ *     Replaces an older entry with the same key. The file is rewritten
+ *     to a temporary file and renamed, so a crash never leaves it half
+ *     written.
+ */
+void tune_store(const char *program, const char *size_class,
+                const tune_config *cfg, double seconds){
+    char line[TUNE_LINE_LEN], machine[TUNE_MACHINE_LEN], tmp[TUNE_LINE_LEN];
+    char l_program[64], l_machine[TUNE_MACHINE_LEN], l_class[TUNE_CLASS_LEN];
+    const char *file = tuning_file();
+    FILE *in = fopen(file, "r");
+    FILE *out;
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", file);
+    out = fopen(tmp, "w");
+    if (!out){
+        perror(tmp);
+        if (in)
+            fclose(in);
+        return;
+    }
+    machine_id(machine);
+
+    if (in){
+        while (fgets(line, sizeof(line), in)){
+            if (line[0] != '#' &&
+                sscanf(line, "%63s %127s %63s", l_program, l_machine, l_class) == 3 &&
+                !strcmp(l_program, program) && !strcmp(l_machine, machine) &&
+                !strcmp(l_class, size_class))
+                continue;
+            fputs(line, out);
+        }
+        fclose(in);
+    }
+    else
+        fprintf(out, "# program machine size_class seconds parameters\n");
+
+    fprintf(out, "%s %s %s %e", program, machine, size_class, seconds);
+    for (int i = 0; i < cfg->count; i++)
+        fprintf(out, " %s=%ld", cfg->name[i], cfg->value[i]);
+    fprintf(out, "\n");
+    fclose(out);
+
+    if (rename(tmp, file) != 0)
+        perror(file);
+}
+
+/* Function:      tune_print
+ * In args:       title, cfg
+ */
+void tune_print(const char *title, const tune_config *cfg){
+    printf("%s:", title);
+    for (int i = 0; i < cfg->count; i++)
+        printf(" %s=%ld", cfg->name[i], cfg->value[i]);
+    printf("\n");
+}
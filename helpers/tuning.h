@@ -0,0 +1,29 @@
+/* File:     tuning.h
+ * Purpose:  Header file for tuning.c, which stores and loads the
+ *           fastest configuration (thread count, schedule, padding...)
+ *           found by a program for a machine and a problem-size class.
+ */
+#ifndef _TUNING_H_
+#define _TUNING_H_
+
+#define TUNE_MAX_PARAMS 8
+#define TUNE_NAME_LEN 16
+#define TUNE_CLASS_LEN 64
+
+/* A configuration is a small set of named integer parameters */
+typedef struct{
+    int count;
+    char name[TUNE_MAX_PARAMS][TUNE_NAME_LEN];
+    long value[TUNE_MAX_PARAMS];
+}tune_config;
+
+void tune_class(char *size_class, const long dims[], int ndims);
+void tune_set(tune_config *cfg, const char *name, long value);
+long tune_get(const tune_config *cfg, const char *name, long fallback);
+int tune_load(const char *program, const char *size_class, tune_config *cfg);
+void tune_store(const char *program, const char *size_class,
+                const tune_config *cfg, double seconds);
+void tune_print(const char *title, const tune_config *cfg);
+int tune_max_threads(void);
+
+#endif